@@ -403,6 +403,34 @@ static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_
 
     GdipGetCompositingMode(graphics, &comp_mode);
 
+    if ((dst_bitmap->format == PixelFormat32bppARGB || dst_bitmap->format == PixelFormat32bppRGB) &&
+        dst_bitmap->bits && !(fmt & PixelFormatPAlpha))
+    {
+        /* Blend straight into the bitmap bits, one row at a time. */
+        DWORD alpha_fill = dst_bitmap->format == PixelFormat32bppRGB ? 0xff000000 : 0;
+        DWORD alpha_mask = dst_bitmap->format == PixelFormat32bppRGB ? 0x00ffffff : 0xffffffff;
+        INT start_x = max(dst_x, 0), end_x = min(dst_x + src_width, dst_bitmap->width);
+        INT start_y = max(dst_y, 0), end_y = min(dst_y + src_height, dst_bitmap->height);
+
+        for (y=start_y; y<end_y; y++)
+        {
+            const ARGB *src_row = (const ARGB*)(src + src_stride * (y - dst_y));
+            DWORD *dst_row = (DWORD*)(dst_bitmap->bits + dst_bitmap->stride * y);
+
+            for (x=start_x; x<end_x; x++)
+            {
+                ARGB src_color = src_row[x - dst_x];
+
+                if (comp_mode == CompositingModeSourceCopy)
+                    dst_row[x] = (src_color & 0xff000000 ? src_color : 0) & alpha_mask;
+                else if (src_color & 0xff000000)
+                    dst_row[x] = color_over(dst_row[x] | alpha_fill, src_color) & alpha_mask;
+            }
+        }
+
+        return Ok;
+    }
+
     for (y=0; y<src_height; y++)
     {
         for (x=0; x<src_width; x++)
@@ -1178,8 +1206,8 @@ static GpStatus brush_fill_pixels(GpGraphics *graphics, GpBrush *brush,
     {
         int x, y;
         GpSolidFill *fill = (GpSolidFill*)brush;
-        for (x=0; x<fill_area->Width; x++)
-            for (y=0; y<fill_area->Height; y++)
+        for (y=0; y<fill_area->Height; y++)
+            for (x=0; x<fill_area->Width; x++)
                 argb_pixels[x + y*cdwStride] = fill->color;
         return Ok;
     }
@@ -4292,6 +4320,377 @@ end:
     return retval;
 }
 
+/* Anti-aliased path filling.
+ *
+ * The flattened path is rasterized one scanline at a time. Each scanline is
+ * sampled at AA_SUBSCANLINES vertical positions, and the horizontal coverage
+ * of every span found on a sub-scanline is computed exactly, in 1/256 pixel
+ * units. */
+#define AA_SUBSCANLINES 8
+#define AA_FULL_COVERAGE (AA_SUBSCANLINES * 256)
+
+struct raster_edge
+{
+    REAL x0, y0, y1;
+    REAL dxdy;
+    INT dir;
+};
+
+struct raster_crossing
+{
+    REAL x;
+    INT dir;
+    INT edge;
+};
+
+static int __cdecl compare_raster_edges(const void *a, const void *b)
+{
+    const struct raster_edge *edge_a = a, *edge_b = b;
+
+    if (edge_a->y0 < edge_b->y0) return -1;
+    return edge_a->y0 > edge_b->y0;
+}
+
+static void add_raster_edge(struct raster_edge *edges, INT *count, const GpPointF *start, const GpPointF *end)
+{
+    struct raster_edge *edge;
+
+    if (start->Y == end->Y)
+        return;
+
+    edge = &edges[(*count)++];
+    if (start->Y < end->Y)
+    {
+        edge->x0 = start->X;
+        edge->y0 = start->Y;
+        edge->y1 = end->Y;
+        edge->dir = 1;
+    }
+    else
+    {
+        edge->x0 = end->X;
+        edge->y0 = end->Y;
+        edge->y1 = start->Y;
+        edge->dir = -1;
+    }
+    edge->dxdy = (end->X - start->X) / (end->Y - start->Y);
+}
+
+/* Adds the span [start, end) to a row of coverage accumulators. Partially
+ * covered pixels go to cover, runs of fully covered pixels are stored as a
+ * start and end delta in fill. */
+static void add_raster_span(INT *cover, INT *fill, INT width, REAL start, REAL end)
+{
+    INT a, b, ia, ib;
+
+    a = start <= 0.0 ? 0 : start >= width ? width * 256 : gdip_round(start * 256.0);
+    b = end <= 0.0 ? 0 : end >= width ? width * 256 : gdip_round(end * 256.0);
+
+    if (b <= a)
+        return;
+
+    ia = a >> 8;
+    ib = b >> 8;
+
+    if (ia == ib)
+    {
+        cover[ia] += b - a;
+        return;
+    }
+
+    cover[ia] += 256 - (a & 0xff);
+    fill[ia + 1] += 256;
+    fill[ib] -= 256;
+    cover[ib] += b & 0xff;
+}
+
+/* Computes an 8-bit coverage mask for the area of the path inside bounds.
+ * Points are in device space, with pixel (x, y) covering [x, x + 1). */
+static GpStatus rasterize_path_coverage(const GpPointF *points, const BYTE *types, INT count,
+    GpFillMode fill_mode, const GpRect *bounds, BYTE *coverage)
+{
+    struct raster_edge *edges;
+    struct raster_crossing *crossings;
+    INT *cover, *fill;
+    INT edge_count = 0, next_edge = 0, active_count = 0;
+    INT *active;
+    INT i, j, x, y, sub, start;
+
+    edges = heap_alloc(sizeof(*edges) * count);
+    active = heap_alloc(sizeof(*active) * count);
+    crossings = heap_alloc(sizeof(*crossings) * count);
+    cover = heap_alloc_zero(sizeof(*cover) * (bounds->Width + 1) * 2);
+    if (!edges || !active || !crossings || !cover)
+    {
+        heap_free(edges);
+        heap_free(active);
+        heap_free(crossings);
+        heap_free(cover);
+        return OutOfMemory;
+    }
+    fill = cover + bounds->Width + 1;
+
+    /* Build the edge list, closing every figure. */
+    for (i = 0, start = 0; i < count; i++)
+    {
+        if (i + 1 == count || (types[i + 1] & PathPointTypePathTypeMask) == PathPointTypeStart)
+        {
+            add_raster_edge(edges, &edge_count, &points[i], &points[start]);
+            start = i + 1;
+        }
+        else
+            add_raster_edge(edges, &edge_count, &points[i], &points[i + 1]);
+    }
+
+    qsort(edges, edge_count, sizeof(*edges), compare_raster_edges);
+
+    for (y = 0; y < bounds->Height; y++)
+    {
+        INT sum;
+
+        for (sub = 0; sub < AA_SUBSCANLINES; sub++)
+        {
+            REAL sample_y = bounds->Y + y + (sub + 0.5) / AA_SUBSCANLINES;
+            INT winding = 0;
+
+            while (next_edge < edge_count && edges[next_edge].y0 <= sample_y)
+                active[active_count++] = next_edge++;
+
+            /* Drop finished edges and find where the others cross this sub-scanline. */
+            for (i = 0, j = 0; i < active_count; i++)
+            {
+                const struct raster_edge *edge = &edges[active[i]];
+                struct raster_crossing crossing;
+
+                if (edge->y1 <= sample_y)
+                    continue;
+
+                crossing.x = edge->x0 + (sample_y - edge->y0) * edge->dxdy - bounds->X;
+                crossing.dir = edge->dir;
+                crossing.edge = active[i];
+
+                /* The active edges are kept in the order of the previous
+                 * sub-scanline, so this insertion sort is close to linear. */
+                for (x = j; x > 0 && crossings[x - 1].x > crossing.x; x--)
+                    crossings[x] = crossings[x - 1];
+                crossings[x] = crossing;
+                j++;
+            }
+            active_count = j;
+
+            for (i = 0; i < active_count; i++)
+            {
+                BOOL inside;
+
+                /* Keep the active edges in crossing order for the next sub-scanline. */
+                active[i] = crossings[i].edge;
+
+                winding += crossings[i].dir;
+                inside = fill_mode == FillModeAlternate ? winding & 1 : winding != 0;
+
+                if (inside && i + 1 < active_count)
+                    add_raster_span(cover, fill, bounds->Width, crossings[i].x, crossings[i + 1].x);
+            }
+        }
+
+        for (x = 0, sum = 0; x < bounds->Width; x++)
+        {
+            INT value;
+
+            sum += fill[x];
+            value = sum + cover[x];
+            coverage[x] = value >= AA_FULL_COVERAGE ? 255 : (value * 255 + AA_FULL_COVERAGE / 2) / AA_FULL_COVERAGE;
+        }
+
+        memset(cover, 0, sizeof(*cover) * (bounds->Width + 1) * 2);
+        coverage += bounds->Width;
+    }
+
+    heap_free(edges);
+    heap_free(active);
+    heap_free(crossings);
+    heap_free(cover);
+
+    return Ok;
+}
+
+/* Blends the pixels with a non-zero coverage to a bitmap, leaving the others
+ * untouched even in CompositingModeSourceCopy. */
+static GpStatus alpha_blend_bmp_coverage(GpGraphics *graphics, const GpRect *rect,
+    const DWORD *src, const BYTE *coverage)
+{
+    GpStatus stat;
+    HRGN hrgn, visible_rgn;
+    RGNDATA *rgndata;
+    RECT *rects;
+    DWORD i;
+    INT size, x, y, start;
+
+    hrgn = CreateRectRgn(rect->X, rect->Y, rect->X + rect->Width, rect->Y + rect->Height);
+    if (!hrgn)
+        return OutOfMemory;
+
+    stat = get_clip_hrgn(graphics, &visible_rgn);
+    if (stat != Ok)
+    {
+        DeleteObject(hrgn);
+        return stat;
+    }
+
+    if (visible_rgn)
+    {
+        CombineRgn(hrgn, hrgn, visible_rgn, RGN_AND);
+        DeleteObject(visible_rgn);
+    }
+
+    size = GetRegionData(hrgn, 0, NULL);
+
+    rgndata = heap_alloc_zero(size);
+    if (!rgndata)
+    {
+        DeleteObject(hrgn);
+        return OutOfMemory;
+    }
+
+    GetRegionData(hrgn, size, rgndata);
+
+    rects = (RECT*)rgndata->Buffer;
+
+    for (i = 0; stat == Ok && i < rgndata->rdh.nCount; i++)
+    {
+        for (y = rects[i].top; stat == Ok && y < rects[i].bottom; y++)
+        {
+            /* Index by the offset into the rectangle, so that no pointer
+             * outside of the source rows is ever formed. */
+            const BYTE *row_coverage = coverage + (y - rect->Y) * rect->Width;
+            const DWORD *row = src + (y - rect->Y) * rect->Width;
+            INT left = rects[i].left - rect->X, right = rects[i].right - rect->X;
+
+            for (x = left; stat == Ok && x < right; )
+            {
+                while (x < right && !row_coverage[x])
+                    x++;
+
+                for (start = x; x < right && row_coverage[x]; x++)
+                    ;
+
+                if (x > start)
+                    stat = alpha_blend_bmp_pixels(graphics, rect->X + start, y, (const BYTE *)&row[start],
+                        x - start, 1, rect->Width * 4, PixelFormat32bppARGB);
+            }
+        }
+    }
+
+    heap_free(rgndata);
+
+    DeleteObject(hrgn);
+
+    return stat;
+}
+
+static GpStatus SOFTWARE_GdipFillPathAntiAlias(GpGraphics *graphics, GpBrush *brush, GpPath *path)
+{
+    GpStatus stat;
+    GpPath *flat_path;
+    GpMatrix world_to_device;
+    GpRectF graphics_bounds;
+    GpRect bound_rect;
+    REAL min_x, min_y, max_x, max_y;
+    DWORD *pixel_data;
+    BYTE *coverage;
+    INT i, left, top, right, bottom;
+
+    stat = gdi_transform_acquire(graphics);
+    if (stat != Ok)
+        return stat;
+
+    stat = get_graphics_device_bounds(graphics, &graphics_bounds);
+
+    if (stat == Ok)
+        stat = get_graphics_transform(graphics, WineCoordinateSpaceGdiDevice,
+            CoordinateSpaceWorld, &world_to_device);
+
+    if (stat == Ok)
+    {
+        /* Pixel centers are at integer coordinates unless the pixels are offset by half a pixel. */
+        if (graphics->pixeloffset != PixelOffsetModeHalf && graphics->pixeloffset != PixelOffsetModeHighQuality)
+            GdipTranslateMatrix(&world_to_device, 0.5, 0.5, MatrixOrderAppend);
+
+        stat = GdipClonePath(path, &flat_path);
+    }
+
+    if (stat != Ok)
+    {
+        gdi_transform_release(graphics);
+        return stat;
+    }
+
+    stat = GdipFlattenPath(flat_path, &world_to_device, FlatnessDefault);
+
+    if (stat == Ok && flat_path->pathdata.Count)
+    {
+        min_x = max_x = flat_path->pathdata.Points[0].X;
+        min_y = max_y = flat_path->pathdata.Points[0].Y;
+        for (i = 1; i < flat_path->pathdata.Count; i++)
+        {
+            min_x = min(min_x, flat_path->pathdata.Points[i].X);
+            min_y = min(min_y, flat_path->pathdata.Points[i].Y);
+            max_x = max(max_x, flat_path->pathdata.Points[i].X);
+            max_y = max(max_y, flat_path->pathdata.Points[i].Y);
+        }
+
+        left = max(floorf(min_x), floorf(graphics_bounds.X));
+        top = max(floorf(min_y), floorf(graphics_bounds.Y));
+        right = min(ceilf(max_x), ceilf(graphics_bounds.X + graphics_bounds.Width));
+        bottom = min(ceilf(max_y), ceilf(graphics_bounds.Y + graphics_bounds.Height));
+
+        if (left < right && top < bottom)
+        {
+            bound_rect.X = left;
+            bound_rect.Y = top;
+            bound_rect.Width = right - left;
+            bound_rect.Height = bottom - top;
+
+            pixel_data = heap_alloc_zero(sizeof(*pixel_data) * bound_rect.Width * bound_rect.Height);
+            coverage = heap_alloc(bound_rect.Width * bound_rect.Height);
+            if (!pixel_data || !coverage)
+                stat = OutOfMemory;
+
+            if (stat == Ok)
+                stat = rasterize_path_coverage(flat_path->pathdata.Points, flat_path->pathdata.Types,
+                    flat_path->pathdata.Count, flat_path->fill, &bound_rect, coverage);
+
+            if (stat == Ok)
+                stat = brush_fill_pixels(graphics, brush, pixel_data, &bound_rect, bound_rect.Width);
+
+            if (stat == Ok)
+            {
+                for (i = 0; i < bound_rect.Width * bound_rect.Height; i++)
+                {
+                    UINT alpha = (pixel_data[i] >> 24) * coverage[i];
+
+                    pixel_data[i] = (pixel_data[i] & 0xffffff) | (((alpha + 127) / 255) << 24);
+                }
+
+                if (graphics->image && graphics->image->type == ImageTypeBitmap)
+                    stat = alpha_blend_bmp_coverage(graphics, &bound_rect, pixel_data, coverage);
+                else
+                    stat = alpha_blend_pixels(graphics, bound_rect.X, bound_rect.Y, (BYTE *)pixel_data,
+                        bound_rect.Width, bound_rect.Height, bound_rect.Width * 4, PixelFormat32bppARGB);
+            }
+
+            heap_free(coverage);
+            heap_free(pixel_data);
+        }
+    }
+
+    GdipDeletePath(flat_path);
+
+    gdi_transform_release(graphics);
+
+    return stat;
+}
+
 static GpStatus SOFTWARE_GdipFillPath(GpGraphics *graphics, GpBrush *brush, GpPath *path)
 {
     GpStatus stat;
@@ -4300,6 +4699,9 @@ static GpStatus SOFTWARE_GdipFillPath(GpGraphics *graphics, GpBrush *brush, GpPa
     if (!brush_can_fill_pixels(brush))
         return NotImplemented;
 
+    if (graphics->smoothing == SmoothingModeAntiAlias || graphics->smoothing == SmoothingModeHighQuality)
+        return SOFTWARE_GdipFillPathAntiAlias(graphics, brush, path);
+
     /* FIXME: This could probably be done more efficiently without regions. */
 
     stat = GdipCreateRegionPath(path, &rgn);
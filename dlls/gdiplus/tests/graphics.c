@@ -1591,6 +1591,69 @@ static void test_GdipFillPath(void)
     ReleaseDC(hwnd, hdc);
 }
 
+static void test_GdipFillPath_antialias(void)
+{
+    GpStatus status;
+    GpBitmap *bitmap;
+    GpGraphics *graphics;
+    GpSolidFill *brush;
+    ARGB color;
+
+    status = GdipCreateBitmapFromScan0(8, 8, 0, PixelFormat32bppARGB, NULL, &bitmap);
+    expect(Ok, status);
+    status = GdipGetImageGraphicsContext((GpImage *)bitmap, &graphics);
+    expect(Ok, status);
+    status = GdipCreateSolidFill((ARGB)0xff0000ff, &brush);
+    expect(Ok, status);
+
+    status = GdipSetSmoothingMode(graphics, SmoothingModeAntiAlias);
+    expect(Ok, status);
+
+    /* Pixel centers are on integer coordinates, so the edges cover half pixels. */
+    status = GdipFillRectangle(graphics, (GpBrush *)brush, 2.0, 2.0, 4.0, 4.0);
+    expect(Ok, status);
+
+    status = GdipBitmapGetPixel(bitmap, 0, 4, &color);
+    expect(Ok, status);
+    expect(0, color);
+    status = GdipBitmapGetPixel(bitmap, 4, 4, &color);
+    expect(Ok, status);
+    expect(0xff0000ff, color);
+    status = GdipBitmapGetPixel(bitmap, 2, 4, &color);
+    expect(Ok, status);
+    ok((color & 0xffffff) == 0xff && (color >> 24) > 0x40 && (color >> 24) < 0xc0,
+       "Expected a partially covered pixel, got %08x\n", color);
+    status = GdipBitmapGetPixel(bitmap, 6, 4, &color);
+    expect(Ok, status);
+    ok((color & 0xffffff) == 0xff && (color >> 24) > 0x40 && (color >> 24) < 0xc0,
+       "Expected a partially covered pixel, got %08x\n", color);
+
+    /* With a half pixel offset the same rectangle is aligned to pixel edges. */
+    status = GdipGraphicsClear(graphics, 0);
+    expect(Ok, status);
+    status = GdipSetPixelOffsetMode(graphics, PixelOffsetModeHalf);
+    expect(Ok, status);
+    status = GdipFillRectangle(graphics, (GpBrush *)brush, 2.0, 2.0, 4.0, 4.0);
+    expect(Ok, status);
+
+    status = GdipBitmapGetPixel(bitmap, 1, 4, &color);
+    expect(Ok, status);
+    expect(0, color);
+    status = GdipBitmapGetPixel(bitmap, 2, 4, &color);
+    expect(Ok, status);
+    expect(0xff0000ff, color);
+    status = GdipBitmapGetPixel(bitmap, 5, 4, &color);
+    expect(Ok, status);
+    expect(0xff0000ff, color);
+    status = GdipBitmapGetPixel(bitmap, 6, 4, &color);
+    expect(Ok, status);
+    expect(0, color);
+
+    GdipDeleteBrush((GpBrush *)brush);
+    GdipDeleteGraphics(graphics);
+    GdipDisposeImage((GpImage *)bitmap);
+}
+
 static void test_Get_Release_DC(void)
 {
     GpStatus status;
@@ -7081,6 +7144,7 @@ START_TEST(graphics)
     test_GdipFillClosedCurve();
     test_GdipFillClosedCurveI();
     test_GdipFillPath();
+    test_GdipFillPath_antialias();
     test_GdipDrawString();
     test_GdipGetNearestColor();
     test_GdipGetVisibleClipBounds();
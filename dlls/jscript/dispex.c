@@ -1751,6 +1751,8 @@ HRESULT init_dispex(jsdisp_t *dispex, script_ctx_t *ctx, const builtin_info_t *b
     script_addref(ctx);
     dispex->ctx = ctx;
 
+    list_add_tail(&ctx->objects, &dispex->entry);
+    ctx->object_cnt++;
     return S_OK;
 }
 
@@ -1787,6 +1789,9 @@ void jsdisp_free(jsdisp_t *obj)
 
     TRACE("(%p)\n", obj);
 
+    list_remove(&obj->entry);
+    obj->ctx->object_cnt--;
+
     for(prop = obj->props; prop < obj->props+obj->prop_cnt; prop++) {
         switch(prop->type) {
         case PROP_JSVAL:
@@ -1814,6 +1819,233 @@ void jsdisp_free(jsdisp_t *obj)
         heap_free(obj);
 }
 
+/*
+ * Cycle collector. Objects are reference counted, which is not enough for cycles created by
+ * closures and objects pointing to each other. The collector uses trial deletion: references
+ * between objects of the script context are subtracted from their reference counts, objects
+ * still having references left are held by something outside of the object graph (the host,
+ * the interpreter or the script context itself) and everything reachable from them is alive.
+ * The rest is garbage and gets unlinked, which breaks the cycles and frees the objects.
+ * Scope chains are refcounted separately and are treated as graph nodes as well.
+ */
+struct gc_ctx {
+    script_ctx_t *script_ctx;
+    jsdisp_t **stack;
+    unsigned stack_cnt;
+    unsigned stack_size;
+    scope_chain_t **scopes;
+    unsigned scope_cnt;
+    unsigned scope_size;
+    BOOL failed;
+};
+
+static BOOL gc_grow(struct gc_ctx *gc, void **buf, unsigned *size, unsigned cnt, size_t elem_size)
+{
+    unsigned new_size;
+    void *new_buf;
+
+    if(cnt < *size)
+        return TRUE;
+
+    new_size = *size ? *size * 2 : 64;
+    new_buf = heap_realloc(*buf, new_size * elem_size);
+    if(!new_buf) {
+        gc->failed = TRUE;
+        return FALSE;
+    }
+
+    *buf = new_buf;
+    *size = new_size;
+    return TRUE;
+}
+
+static void gc_mark_obj(struct gc_ctx *gc, jsdisp_t *obj)
+{
+    if(obj->ctx != gc->script_ctx || obj->gc_marked)
+        return;
+
+    obj->gc_marked = TRUE;
+    if(gc_grow(gc, (void**)&gc->stack, &gc->stack_size, gc->stack_cnt, sizeof(*gc->stack)))
+        gc->stack[gc->stack_cnt++] = obj;
+}
+
+static void gc_mark_scope(struct gc_ctx *gc, scope_chain_t *scope)
+{
+    jsdisp_t *obj;
+
+    for(; scope && !scope->gc_marked; scope = scope->next) {
+        scope->gc_marked = TRUE;
+        if((obj = to_jsdisp(scope->obj)))
+            gc_mark_obj(gc, obj);
+    }
+}
+
+void gc_process_linked_obj(struct gc_ctx *gc, enum gc_traverse_op op, jsdisp_t *link, void **unlink_ref)
+{
+    switch(op) {
+    case GC_TRAVERSE_UNLINK:
+        *unlink_ref = NULL;
+        jsdisp_release(link);
+        break;
+    case GC_TRAVERSE_SPECULATIVELY:
+        if(link->ctx == gc->script_ctx)
+            link->gc_refs--;
+        break;
+    case GC_TRAVERSE:
+        gc_mark_obj(gc, link);
+        break;
+    }
+}
+
+void gc_process_linked_val(struct gc_ctx *gc, enum gc_traverse_op op, jsval_t *link)
+{
+    jsdisp_t *obj;
+
+    if(op == GC_TRAVERSE_UNLINK) {
+        jsval_t val = *link;
+        *link = jsval_undefined();
+        jsval_release(val);
+        return;
+    }
+
+    if(is_object_instance(*link) && get_object(*link) && (obj = to_jsdisp(get_object(*link))))
+        gc_process_linked_obj(gc, op, obj, NULL);
+}
+
+void gc_process_linked_scope(struct gc_ctx *gc, enum gc_traverse_op op, scope_chain_t **link)
+{
+    scope_chain_t *scope = *link;
+    jsdisp_t *obj;
+
+    switch(op) {
+    case GC_TRAVERSE_UNLINK:
+        *link = NULL;
+        scope_release(scope);
+        break;
+    case GC_TRAVERSE_SPECULATIVELY:
+        /* Scopes are found through the objects linking them, their own links are subtracted once. */
+        for(; scope; scope = scope->next) {
+            if(scope->gc_visited) {
+                scope->gc_refs--;
+                break;
+            }
+            if(!gc_grow(gc, (void**)&gc->scopes, &gc->scope_size, gc->scope_cnt, sizeof(*gc->scopes)))
+                break;
+            gc->scopes[gc->scope_cnt++] = scope;
+            scope->gc_visited = TRUE;
+            scope->gc_marked = FALSE;
+            scope->gc_refs = scope->ref - 1;
+            if((obj = to_jsdisp(scope->obj)))
+                gc_process_linked_obj(gc, op, obj, NULL);
+        }
+        break;
+    case GC_TRAVERSE:
+        gc_mark_scope(gc, scope);
+        break;
+    }
+}
+
+static void gc_traverse_obj(struct gc_ctx *gc, enum gc_traverse_op op, jsdisp_t *obj)
+{
+    dispex_prop_t *prop;
+
+    for(prop = obj->props; prop < obj->props + obj->prop_cnt; prop++) {
+        switch(prop->type) {
+        case PROP_JSVAL:
+            gc_process_linked_val(gc, op, &prop->u.val);
+            break;
+        case PROP_ACCESSOR:
+            if(prop->u.accessor.getter)
+                gc_process_linked_obj(gc, op, prop->u.accessor.getter, (void**)&prop->u.accessor.getter);
+            if(prop->u.accessor.setter)
+                gc_process_linked_obj(gc, op, prop->u.accessor.setter, (void**)&prop->u.accessor.setter);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if(obj->prototype)
+        gc_process_linked_obj(gc, op, obj->prototype, (void**)&obj->prototype);
+
+    if(obj->builtin_info->gc_traverse)
+        obj->builtin_info->gc_traverse(gc, op, obj);
+}
+
+void gc_run(script_ctx_t *ctx)
+{
+    struct gc_ctx gc = { ctx };
+    unsigned i, obj_cnt = ctx->object_cnt, garbage_cnt = 0;
+    jsdisp_t *obj, **garbage = NULL;
+
+    /* Freeing objects may release host objects, which may call back into the script. */
+    if(ctx->gc_running)
+        return;
+
+    TRACE("%p: %u objects\n", ctx, obj_cnt);
+
+    ctx->gc_requested = FALSE;
+
+    /* Keep the context alive while its last objects are freed. */
+    script_addref(ctx);
+    ctx->gc_running = TRUE;
+
+    LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, entry) {
+        obj->gc_refs = obj->ref;
+        obj->gc_marked = FALSE;
+    }
+
+    LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, entry)
+        gc_traverse_obj(&gc, GC_TRAVERSE_SPECULATIVELY, obj);
+
+    LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, entry) {
+        if(obj->gc_refs > 0)
+            gc_mark_obj(&gc, obj);
+    }
+    for(i = 0; i < gc.scope_cnt; i++) {
+        if(gc.scopes[i]->gc_refs > 0)
+            gc_mark_scope(&gc, gc.scopes[i]);
+    }
+    while(gc.stack_cnt && !gc.failed)
+        gc_traverse_obj(&gc, GC_TRAVERSE, gc.stack[--gc.stack_cnt]);
+
+    for(i = 0; i < gc.scope_cnt; i++)
+        gc.scopes[i]->gc_visited = gc.scopes[i]->gc_marked = FALSE;
+    heap_free(gc.scopes);
+    heap_free(gc.stack);
+
+    if(!gc.failed) {
+        LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, entry) {
+            if(!obj->gc_marked)
+                garbage_cnt++;
+        }
+        if(garbage_cnt && !(garbage = heap_alloc(garbage_cnt * sizeof(*garbage))))
+            garbage_cnt = 0;
+        if(garbage_cnt) {
+            i = 0;
+            LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, entry) {
+                if(!obj->gc_marked)
+                    garbage[i++] = jsdisp_addref(obj);
+            }
+
+            /* Unlinked objects are kept alive until all of them are unlinked. */
+            for(i = 0; i < garbage_cnt; i++)
+                gc_traverse_obj(&gc, GC_TRAVERSE_UNLINK, garbage[i]);
+            for(i = 0; i < garbage_cnt; i++)
+                jsdisp_release(garbage[i]);
+            heap_free(garbage);
+        }
+    }else {
+        WARN("out of memory, skipping collection\n");
+    }
+
+    ctx->gc_threshold = max(ctx->object_cnt * 2, GC_MIN_THRESHOLD);
+    TRACE("%p: collected %u of %u objects, %u left, next collection at %u objects\n", ctx, garbage_cnt,
+          obj_cnt, ctx->object_cnt, ctx->gc_threshold);
+    ctx->gc_running = FALSE;
+    script_release(ctx);
+}
+
 #ifdef TRACE_REFCNT
 
 jsdisp_t *jsdisp_addref(jsdisp_t *jsdisp)
@@ -1895,6 +2127,32 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * Properties never move once they are allocated, so objects which got the same properties
+ * added in the same order (like objects created by the same constructor) share their layout.
+ * Bytecode sites cache the DISPID of the last lookup and reuse it for any object having
+ * the property of the same name in that slot, which skips hashing and bucket walks.
+ */
+HRESULT jsdisp_get_cached_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *cache, DISPID *id)
+{
+    DISPID cached = *cache;
+    HRESULT hres;
+
+    if(cached > 0 && cached < jsdisp->prop_cnt) {
+        dispex_prop_t *prop = jsdisp->props + cached;
+
+        if(prop->type != PROP_DELETED && !wcscmp(prop->name, name)) {
+            *id = cached;
+            return S_OK;
+        }
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(SUCCEEDED(hres))
+        *cache = *id;
+    return hres;
+}
+
 HRESULT jsdisp_call_value(jsdisp_t *jsfunc, IDispatch *jsthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
     HRESULT hres;
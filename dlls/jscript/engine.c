@@ -391,6 +391,8 @@ static HRESULT scope_push(scope_chain_t *scope, jsdisp_t *jsobj, IDispatch *obj,
     new_scope->obj = obj;
     new_scope->frame = NULL;
     new_scope->next = scope ? scope_addref(scope) : NULL;
+    new_scope->gc_visited = FALSE;
+    new_scope->gc_marked = FALSE;
 
     *ret = new_scope;
     return S_OK;
@@ -454,6 +456,21 @@ static HRESULT disp_get_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name
     return hres;
 }
 
+static HRESULT disp_get_cached_id(script_ctx_t *ctx, IDispatch *disp, const WCHAR *name, BSTR name_bstr, DWORD flags,
+        DISPID *cache, DISPID *id)
+{
+    jsdisp_t *jsdisp;
+    HRESULT hres;
+
+    jsdisp = iface_to_jsdisp(disp);
+    if(!jsdisp)
+        return disp_get_id(ctx, disp, name, name_bstr, flags, id);
+
+    hres = jsdisp_get_cached_id(jsdisp, name, flags, cache, id);
+    jsdisp_release(jsdisp);
+    return hres;
+}
+
 static HRESULT disp_cmp(IDispatch *disp1, IDispatch *disp2, BOOL *ret)
 {
     IObjectIdentity *identity;
@@ -719,6 +736,13 @@ static inline jsstr_t *get_op_str(script_ctx_t *ctx, int i)
     return frame->bytecode->instrs[frame->ip].u.arg[i].str;
 }
 
+/* Member access instructions keep the DISPID of the last lookup in their unused second argument. */
+static inline DISPID *get_op_id_cache(script_ctx_t *ctx)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    return &frame->bytecode->instrs[frame->ip].u.arg[1].lng;
+}
+
 static inline double get_op_double(script_ctx_t *ctx)
 {
     call_frame_t *frame = ctx->call_ctx;
@@ -735,6 +759,26 @@ static inline void jmp_abs(script_ctx_t *ctx, unsigned dst)
     ctx->call_ctx->ip = dst;
 }
 
+/*
+ * Conditions are usually consumed by a following jmp_z. In that case take the jump
+ * directly instead of pushing a boolean and dispatching the jump separately.
+ * The dispatch loop moves past the current instruction afterwards.
+ */
+static HRESULT push_cond(script_ctx_t *ctx, BOOL b)
+{
+    call_frame_t *frame = ctx->call_ctx;
+    const instr_t *next = frame->bytecode->instrs + frame->ip + 1;
+
+    if(next->op != OP_jmp_z)
+        return stack_push(ctx, jsval_bool(b));
+
+    if(b)
+        jmp_next(ctx);
+    else
+        jmp_abs(ctx, next->u.arg[0].uint - 1);
+    return S_OK;
+}
+
 /* ECMA-262 3rd Edition    12.6.4 */
 static HRESULT interp_forin(script_ctx_t *ctx)
 {
@@ -1093,7 +1137,7 @@ static HRESULT interp_member(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, arg, arg, 0, &id);
+    hres = disp_get_cached_id(ctx, obj, arg, arg, 0, get_op_id_cache(ctx), &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1135,7 +1179,7 @@ static HRESULT interp_memberid(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx, obj, name, NULL, arg, &id);
+    hres = disp_get_cached_id(ctx, obj, name, NULL, arg, get_op_id_cache(ctx), &id);
     jsstr_release(name_str);
     if(SUCCEEDED(hres)) {
         ref.type = EXPRVAL_IDREF;
@@ -1731,6 +1775,9 @@ static HRESULT interp_add(script_ctx_t *ctx)
 
     TRACE("%s + %s\n", debugstr_jsval(lval), debugstr_jsval(rval));
 
+    if(is_number(lval) && is_number(rval))
+        return stack_push(ctx, jsval_number(get_number(lval) + get_number(rval)));
+
     hres = to_primitive(ctx, lval, &l, NO_HINT);
     if(SUCCEEDED(hres)) {
         hres = to_primitive(ctx, rval, &r, NO_HINT);
@@ -2245,7 +2292,7 @@ static HRESULT interp_eq(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(b));
+    return push_cond(ctx, b);
 }
 
 /* ECMA-262 3rd Edition    11.9.2 */
@@ -2266,7 +2313,7 @@ static HRESULT interp_neq(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(!b));
+    return push_cond(ctx, !b);
 }
 
 /* ECMA-262 3rd Edition    11.9.4 */
@@ -2287,7 +2334,7 @@ static HRESULT interp_eq2(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(b));
+    return push_cond(ctx, b);
 }
 
 /* ECMA-262 3rd Edition    11.9.5 */
@@ -2308,7 +2355,7 @@ static HRESULT interp_neq2(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(!b));
+    return push_cond(ctx, !b);
 }
 
 /* ECMA-262 3rd Edition    11.8.5 */
@@ -2318,6 +2365,13 @@ static HRESULT less_eval(script_ctx_t *ctx, jsval_t lval, jsval_t rval, BOOL gre
     jsval_t l, r;
     HRESULT hres;
 
+    if(is_number(lval) && is_number(rval)) {
+        ln = get_number(lval);
+        rn = get_number(rval);
+        *ret = !isnan(ln) && !isnan(rn) && ((ln < rn) ^ greater);
+        return S_OK;
+    }
+
     hres = to_primitive(ctx, lval, &l, NO_HINT);
     if(FAILED(hres))
         return hres;
@@ -2365,7 +2419,7 @@ static HRESULT interp_lt(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(b));
+    return push_cond(ctx, b);
 }
 
 /* ECMA-262 3rd Edition    11.8.1 */
@@ -2386,7 +2440,7 @@ static HRESULT interp_lteq(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(b));
+    return push_cond(ctx, b);
 }
 
 /* ECMA-262 3rd Edition    11.8.2 */
@@ -2407,7 +2461,7 @@ static HRESULT interp_gt(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(b));
+    return push_cond(ctx, b);
 }
 
 /* ECMA-262 3rd Edition    11.8.4 */
@@ -2428,7 +2482,7 @@ static HRESULT interp_gteq(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(b));
+    return push_cond(ctx, b);
 }
 
 /* ECMA-262 3rd Edition    11.4.8 */
@@ -2464,7 +2518,7 @@ static HRESULT interp_neg(script_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    return stack_push(ctx, jsval_bool(!b));
+    return push_cond(ctx, !b);
 }
 
 /* ECMA-262 3rd Edition    11.7.1 */
@@ -3135,7 +3189,12 @@ HRESULT exec_source(script_ctx_t *ctx, DWORD flags, bytecode_t *bytecode, functi
         return S_OK;
     }
 
-    return enter_bytecode(ctx, r);
+    hres = enter_bytecode(ctx, r);
+
+    /* Objects are not borrowed by the engine once the outermost call returns, so it's safe to collect them. */
+    if(!ctx->call_ctx && (ctx->gc_requested || ctx->object_cnt >= ctx->gc_threshold))
+        gc_run(ctx);
+    return hres;
 
 fail:
     jsdisp_release(variable_obj);
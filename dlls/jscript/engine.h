@@ -213,9 +213,14 @@ typedef struct _scope_chain_t {
     IDispatch *obj;
     struct _call_frame_t *frame;
     struct _scope_chain_t *next;
+
+    LONG gc_refs;
+    BOOL gc_visited;
+    BOOL gc_marked;
 } scope_chain_t;
 
 void scope_release(scope_chain_t*) DECLSPEC_HIDDEN;
+void gc_process_linked_scope(struct gc_ctx*,enum gc_traverse_op,scope_chain_t**) DECLSPEC_HIDDEN;
 
 static inline scope_chain_t *scope_addref(scope_chain_t *scope)
 {
@@ -597,9 +597,16 @@ static HRESULT JSGlobal_ScriptEngineBuildVersion(script_ctx_t *ctx, vdisp_t *jst
 static HRESULT JSGlobal_CollectGarbage(script_ctx_t *ctx, vdisp_t *jsthis, WORD flags, unsigned argc, jsval_t *argv,
         jsval_t *r)
 {
-    static int once = 0;
-    if (!once++)
-        FIXME(": stub\n");
+    TRACE("\n");
+
+    /* Objects may be borrowed by the active call frames, so the collection
+     * is postponed until the outermost call returns. */
+    if(ctx->call_ctx)
+        ctx->gc_requested = TRUE;
+    else
+        gc_run(ctx);
+    if(r)
+        *r = jsval_undefined();
     return S_OK;
 }
 
@@ -493,6 +493,8 @@ static void decrease_state(JScript *This, SCRIPTSTATE state)
                 jsdisp_release(This->ctx->global);
                 This->ctx->global = NULL;
             }
+            if(!This->ctx->call_ctx)
+                gc_run(This->ctx);
             /* FALLTHROUGH */
         case SCRIPTSTATE_UNINITIALIZED:
             change_state(This, state);
@@ -732,6 +734,8 @@ static HRESULT WINAPI JScript_SetScriptSite(IActiveScript *iface,
         ctx->html_mode = This->html_mode;
         ctx->acc = jsval_undefined();
         list_init(&ctx->named_items);
+        list_init(&ctx->objects);
+        ctx->gc_threshold = GC_MIN_THRESHOLD;
         heap_pool_init(&ctx->tmp_heap);
 
         hres = create_jscaller(ctx);
@@ -226,6 +226,14 @@ typedef struct {
     builtin_setter_t setter;
 } builtin_prop_t;
 
+enum gc_traverse_op {
+    GC_TRAVERSE_UNLINK,
+    GC_TRAVERSE_SPECULATIVELY,
+    GC_TRAVERSE
+};
+
+struct gc_ctx;
+
 typedef struct {
     jsclass_t class;
     builtin_prop_t value_prop;
@@ -236,6 +244,7 @@ typedef struct {
     unsigned (*idx_length)(jsdisp_t*);
     HRESULT (*idx_get)(jsdisp_t*,unsigned,jsval_t*);
     HRESULT (*idx_put)(jsdisp_t*,unsigned,jsval_t);
+    void (*gc_traverse)(struct gc_ctx*,enum gc_traverse_op,jsdisp_t*);
 } builtin_info_t;
 
 struct jsdisp_t {
@@ -251,6 +260,10 @@ struct jsdisp_t {
     jsdisp_t *prototype;
 
     const builtin_info_t *builtin_info;
+
+    struct list entry;
+    LONG gc_refs;
+    BOOL gc_marked;
 };
 
 static inline IDispatch *to_disp(jsdisp_t *jsdisp)
@@ -289,6 +302,12 @@ void jsdisp_release(jsdisp_t*) DECLSPEC_HIDDEN;
 
 #endif
 
+void gc_process_linked_obj(struct gc_ctx*,enum gc_traverse_op,jsdisp_t*,void**) DECLSPEC_HIDDEN;
+void gc_process_linked_val(struct gc_ctx*,enum gc_traverse_op,jsval_t*) DECLSPEC_HIDDEN;
+#define GC_MIN_THRESHOLD 4096
+
+void gc_run(script_ctx_t*) DECLSPEC_HIDDEN;
+
 HRESULT create_dispex(script_ctx_t*,const builtin_info_t*,jsdisp_t*,jsdisp_t**) DECLSPEC_HIDDEN;
 HRESULT init_dispex(jsdisp_t*,script_ctx_t*,const builtin_info_t*,jsdisp_t*) DECLSPEC_HIDDEN;
 HRESULT init_dispex_from_constr(jsdisp_t*,script_ctx_t*,const builtin_info_t*,jsdisp_t*) DECLSPEC_HIDDEN;
@@ -307,6 +326,7 @@ HRESULT jsdisp_propput_idx(jsdisp_t*,DWORD,jsval_t) DECLSPEC_HIDDEN;
 HRESULT jsdisp_propget_name(jsdisp_t*,LPCWSTR,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_idx(jsdisp_t*,DWORD,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_id(jsdisp_t*,const WCHAR*,DWORD,DISPID*) DECLSPEC_HIDDEN;
+HRESULT jsdisp_get_cached_id(jsdisp_t*,const WCHAR*,DWORD,DISPID*,DISPID*) DECLSPEC_HIDDEN;
 HRESULT disp_delete(IDispatch*,DISPID,BOOL*) DECLSPEC_HIDDEN;
 HRESULT disp_delete_name(script_ctx_t*,IDispatch*,jsstr_t*,BOOL*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_delete_idx(jsdisp_t*,DWORD) DECLSPEC_HIDDEN;
@@ -429,6 +449,12 @@ struct _script_ctx_t {
     unsigned stack_top;
     jsval_t acc;
 
+    struct list objects;
+    unsigned object_cnt;
+    unsigned gc_threshold;
+    BOOL gc_running;
+    BOOL gc_requested;
+
     jsstr_t *last_match;
     match_result_t match_parens[9];
     DWORD last_match_index;
@@ -231,6 +231,12 @@ typedef struct REBackTrackData {
 #define INITIAL_STATESTACK  100
 #define INITIAL_BACKTRACK   8000
 
+/*
+ * Upper limit on backtracks from a single start position. Exponential
+ * patterns fail instead of hanging the script.
+ */
+#define BACKTRACK_LIMIT     (1 << 26)
+
 typedef struct REGlobalData {
     void *cx;
     regexp_t *regexp;               /* the RE in execution */
@@ -3014,6 +3020,7 @@ ExecuteREBytecode(REGlobalData *gData, match_state_t *x)
             gData->backTrackCount++;
             if (gData->backTrackLimit &&
                 gData->backTrackCount >= gData->backTrackLimit) {
+                WARN("backtrack limit reached\n");
                 JS_ReportErrorNumber(gData->cx, js_GetErrorMessage, NULL,
                                      JSMSG_REGEXP_TOO_COMPLEX);
                 gData->ok = FALSE;
@@ -3070,6 +3077,69 @@ good:
     return x;
 }
 
+/*
+ * Find the first occurrence of ch in [cp, cpend). Four characters are
+ * compared at a time using the "has zero" bit trick on their XOR with ch.
+ */
+static const WCHAR *
+FindChar(const WCHAR *cp, const WCHAR *cpend, WCHAR ch)
+{
+    const UINT64 ones = 0x0001000100010001ull, highs = 0x8000800080008000ull;
+    UINT64 pattern = ch * ones, v;
+
+    while (cpend - cp >= 4) {
+        memcpy(&v, cp, sizeof(v));
+        v ^= pattern;
+        if ((v - ones) & ~v & highs)
+            break;
+        cp += 4;
+    }
+    for (; cp < cpend; cp++) {
+        if (*cp == ch)
+            return cp;
+    }
+    return NULL;
+}
+
+/*
+ * Find the first position at or after cp where the literal prefix of the
+ * regular expression matches, NULL if there is none.
+ */
+static const WCHAR *
+FindPrefix(const regexp_t *re, const WCHAR *cp, const WCHAR *cpend)
+{
+    const WCHAR *last;
+    WCHAR ch;
+    DWORD i;
+
+    if ((size_t)(cpend - cp) < re->prefix_len)
+        return NULL;
+    last = cpend - re->prefix_len;
+
+    if (re->flags & REG_FOLD) {
+        ch = towupper(re->prefix[0]);
+        for (; cp <= last; cp++) {
+            if (towupper(*cp) != ch)
+                continue;
+            for (i = 1; i < re->prefix_len; i++) {
+                if (towupper(cp[i]) != towupper(re->prefix[i]))
+                    break;
+            }
+            if (i == re->prefix_len)
+                return cp;
+        }
+        return NULL;
+    }
+
+    ch = re->prefix[0];
+    while ((cp = FindChar(cp, last + 1, ch))) {
+        if (!memcmp(cp + 1, re->prefix + 1, (re->prefix_len - 1) * sizeof(WCHAR)))
+            return cp;
+        cp++;
+    }
+    return NULL;
+}
+
 static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
 {
     match_state_t *result;
@@ -3082,7 +3152,14 @@ static match_state_t *MatchRegExp(REGlobalData *gData, match_state_t *x)
      * in order to detect end-of-input/line condition.
      */
     for (cp2 = cp; cp2 <= gData->cpend; cp2++) {
+        /* Skip positions where the literal prefix can't match. */
+        if (gData->regexp->prefix_len && !(gData->regexp->flags & REG_STICKY)) {
+            cp2 = FindPrefix(gData->regexp, cp2, gData->cpend);
+            if (!cp2)
+                return NULL;
+        }
         gData->skipped = cp2 - cp;
+        gData->backTrackCount = 0;
         x->cp = cp2;
         for (j = 0; j < gData->regexp->parenCount; j++)
             x->parens[j].index = -1;
@@ -3109,7 +3186,7 @@ static HRESULT InitMatch(regexp_t *re, void *cx, heap_pool_t *pool, REGlobalData
     gData->backTrackSP = gData->backTrackStack;
     gData->cursz = 0;
     gData->backTrackCount = 0;
-    gData->backTrackLimit = 0;
+    gData->backTrackLimit = BACKTRACK_LIMIT;
 
     gData->stateStackLimit = INITIAL_STATESTACK;
     gData->stateStack = heap_pool_alloc(gData->pool, sizeof(REProgState) * INITIAL_STATESTACK);
@@ -3192,6 +3269,54 @@ void regexp_destroy(regexp_t *re)
     heap_free(re);
 }
 
+/*
+ * Collect the literal characters every match has to start with, so that
+ * MatchRegExp can skip start positions that can't match. Capturing parens
+ * are zero-width and don't end the prefix, anything else does.
+ */
+static void
+FindLiteralPrefix(regexp_t *re)
+{
+    jsbytecode *pc = re->program;
+    size_t offset, length, i;
+    WCHAR ch;
+
+    re->prefix_len = 0;
+    for (;;) {
+        switch ((REOp) *pc++) {
+          case REOP_LPAREN:
+          case REOP_RPAREN:
+            pc = ReadCompactIndex(pc, &i);
+            continue;
+          case REOP_FLAT:
+          case REOP_FLATi:
+            pc = ReadCompactIndex(pc, &offset);
+            pc = ReadCompactIndex(pc, &length);
+            for (i = 0; i < length; i++) {
+                if (re->prefix_len == REGEXP_MAX_PREFIX)
+                    return;
+                re->prefix[re->prefix_len++] = re->source[offset + i];
+            }
+            continue;
+          case REOP_FLAT1:
+          case REOP_FLAT1i:
+            ch = *pc++;
+            break;
+          case REOP_UCFLAT1:
+          case REOP_UCFLAT1i:
+            ch = GET_ARG(pc);
+            pc += ARG_LEN;
+            break;
+          default:
+            return;
+        }
+
+        if (re->prefix_len == REGEXP_MAX_PREFIX)
+            return;
+        re->prefix[re->prefix_len++] = ch;
+    }
+}
+
 regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
         DWORD str_len, WORD flags, BOOL flat)
 {
@@ -3281,6 +3406,8 @@ regexp_t* regexp_new(void *cx, heap_pool_t *pool, const WCHAR *str,
     re->parenCount = state.parenCount;
     re->source = str;
     re->source_len = str_len;
+    FindLiteralPrefix(re);
+    TRACE("literal prefix %s\n", debugstr_wn(re->prefix, re->prefix_len));
 
 out:
     heap_pool_clear(mark);
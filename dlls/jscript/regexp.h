@@ -51,6 +51,8 @@ typedef struct match_state_t {
 
 typedef BYTE jsbytecode;
 
+#define REGEXP_MAX_PREFIX 16
+
 typedef struct regexp_t {
     WORD                flags;         /* flags, see jsapi.h's REG_* defines */
     size_t              parenCount;    /* number of parenthesized submatches */
@@ -58,6 +60,8 @@ typedef struct regexp_t {
     struct RECharSet    *classList;    /* list of [...] bitmaps */
     const WCHAR         *source;       /* locked source string, sans // */
     DWORD               source_len;
+    DWORD               prefix_len;    /* length of literal every match starts with */
+    WCHAR               prefix[REGEXP_MAX_PREFIX];
     jsbytecode          program[1];    /* regular expression bytecode */
 } regexp_t;
 
@@ -0,0 +1,27 @@
+/*
+ * Function call benchmark: calls of global functions, methods found
+ * through the prototype chain and builtin methods.
+ */
+
+function add(a, b) {
+    return a + b;
+}
+
+function Counter() {
+    this.count = 0;
+}
+
+Counter.prototype.increment = function(n) {
+    this.count = add(this.count, n);
+    return this;
+};
+
+var counter = new Counter(), str = "abcdefgh", i, n = 0;
+
+for(i = 0; i < 200000; i++) {
+    counter.increment(1).increment(i & 1);
+    n = add(n, str.charCodeAt(i & 7) - 97);
+}
+
+if(counter.count !== 300000 || n !== 700000)
+    throw "unexpected result " + counter.count + " " + n;
@@ -0,0 +1,36 @@
+/*
+ * Closure benchmark: creation of closures and access to variables of the
+ * enclosing scopes.
+ */
+
+function makeAccumulator(start) {
+    var total = start;
+
+    return {
+        add: function(n) { total += n; return total; },
+        get: function() { return total; }
+    };
+}
+
+function compose(f, g) {
+    return function(x) { return f(g(x)); };
+}
+
+var accs = [], i, j, r = 0;
+var inc = function(x) { return x + 1; };
+var twice = compose(inc, inc);
+
+for(i = 0; i < 10; i++)
+    accs.push(makeAccumulator(i));
+
+for(j = 0; j < 20000; j++) {
+    for(i = 0; i < accs.length; i++)
+        accs[i].add(twice(i) - i);
+    r = makeAccumulator(j).add(1);
+}
+
+for(i = 0; i < accs.length; i++)
+    r += accs[i].get();
+
+if(r !== 400045 + 20000)
+    throw "unexpected result " + r;
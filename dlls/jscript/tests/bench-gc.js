@@ -0,0 +1,44 @@
+/*
+ * Garbage collection benchmark: creation of objects referencing each other
+ * and closures capturing their own scope, which can't be freed by reference
+ * counting alone.
+ */
+
+function Node(parent) {
+    var self = this;
+
+    this.parent = parent;
+    this.children = [];
+    this.root = function() { return parent ? parent.root() : self; };
+    if(parent)
+        parent.children.push(this);
+}
+
+function makeTree(depth, parent) {
+    var node = new Node(parent), i;
+
+    if(depth)
+        for(i = 0; i < 3; i++)
+            makeTree(depth - 1, node);
+    return node;
+}
+
+function countNodes(node) {
+    var i, r = 1;
+
+    for(i = 0; i < node.children.length; i++)
+        r += countNodes(node.children[i]);
+    return r;
+}
+
+var i, r = 0, tree;
+
+for(i = 0; i < 2000; i++) {
+    tree = makeTree(4, null);
+    r += countNodes(tree);
+    if(tree.children[2].children[1].root() !== tree)
+        throw "unexpected root";
+}
+
+if(r !== 121 * 2000)
+    throw "unexpected result " + r;
@@ -0,0 +1,36 @@
+/*
+ * Property access benchmark: reads and writes of named properties on objects
+ * sharing their layout, on objects with different layouts and through the
+ * prototype chain.
+ */
+
+function Point(x, y) {
+    this.x = x;
+    this.y = y;
+}
+
+Point.prototype.scale = 2;
+
+function Point3(x, y, z) {
+    this.z = z;
+    this.x = x;
+    this.y = y;
+}
+
+Point3.prototype.scale = 3;
+
+var points = [], i, j, sum = 0;
+
+for(i = 0; i < 100; i++)
+    points.push(i % 4 ? new Point(i, i + 1) : new Point3(i, i + 1, i + 2));
+
+for(j = 0; j < 2000; j++) {
+    for(i = 0; i < points.length; i++) {
+        var p = points[i];
+        sum += p.x * p.scale + p.y;
+        p.x = p.y - 1;
+    }
+}
+
+if(sum !== 32300000)
+    throw "unexpected sum " + sum;
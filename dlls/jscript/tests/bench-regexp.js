@@ -0,0 +1,43 @@
+/*
+ * Regular expression benchmark: log parsing with literal, case insensitive
+ * and capturing patterns over a large input.
+ */
+
+var levels = ["INFO", "DEBUG", "WARN", "ERROR"];
+var lines = [], i, log, m, n, r;
+
+for(i = 0; i < 20000; i++)
+    lines.push("2020-01-" + (10 + i % 20) + " 12:" + (10 + i % 50) + ":00 [" + levels[i % 4] + "] worker" +
+               (i % 7) + ": request " + i + " took " + (i % 900) + "ms" +
+               (i % 5 ? "" : " (timeout=" + (i % 3) + ")"));
+log = lines.join("\n");
+
+/* literal search */
+n = 0;
+r = /timeout=/g;
+while(r.exec(log))
+    n++;
+if(n !== 4000)
+    throw "unexpected timeout count " + n;
+
+/* case insensitive search */
+n = log.match(/error/ig).length;
+if(n !== 5000)
+    throw "unexpected error count " + n;
+
+/* captures */
+n = 0;
+r = /\[(WARN|ERROR)\] worker(\d): request (\d+) took (\d+)ms/g;
+while((m = r.exec(log)))
+    n += parseInt(m[4]);
+if(n !== 4470000)
+    throw "unexpected total time " + n;
+
+/* replace and split */
+n = log.replace(/worker(\d)/g, "w$1").split(/\n/).length;
+if(n !== 20000)
+    throw "unexpected line count " + n;
+
+/* no match at all */
+if(/request 1000000 took/.test(log))
+    throw "unexpected match";
@@ -1898,6 +1898,75 @@ function returnTest() {
 
 ok(returnTest() === undefined, "returnTest = " + returnTest());
 
+/* member access sites cache property lookups, make sure they see layout changes */
+function testMemberCache() {
+    function get(o) { return o.x; }
+    function set(o, v) { o.x = v; }
+    function Proto() {}
+    Proto.prototype.x = "proto";
+
+    var a = {x: 1, y: 2}, b = {y: 3, x: 4}, c = {z: 5}, d = new Proto(), i, r;
+
+    for(i = 0; i < 2; i++) {
+        ok(get(a) === 1, "get(a) = " + get(a));
+        ok(get(b) === 4, "get(b) = " + get(b));
+        ok(get(c) === undefined, "get(c) = " + get(c));
+        ok(get(d) === "proto", "get(d) = " + get(d));
+    }
+
+    set(d, "own");
+    ok(get(d) === "own", "get(d) = " + get(d) + " after set");
+    ok(Proto.prototype.x === "proto", "Proto.prototype.x = " + Proto.prototype.x);
+    delete d.x;
+    ok(get(d) === "proto", "get(d) = " + get(d) + " after delete");
+
+    delete a.x;
+    ok(get(a) === undefined, "get(a) = " + get(a) + " after delete");
+    set(a, 6);
+    ok(get(a) === 6, "get(a) = " + get(a) + " after set");
+
+    set(c, 7);
+    ok(get(c) === 7, "get(c) = " + get(c));
+    ok(c.z === 5, "c.z = " + c.z);
+
+    r = "";
+    for(i in {p: 1, q: 2})
+        r += [{p: "a", q: "b"}, {q: "c", p: "d"}][i === "p" ? 0 : 1][i];
+    ok(r === "ac", "r = " + r);
+}
+
+testMemberCache();
+
+/* conditions followed by a conditional jump are evaluated without pushing the result */
+function testConditionJumps() {
+    var i, n = 0, nan = NaN, o = {valueOf: function() { n += 100; return 1; }};
+
+    for(i = 0; i < 10; i++) {
+        if(i <= 2 || i >= 8) n++;
+        if(i > 3 && i < 5) n += 10;
+        if(!(i == 6)) n += 1000;
+        if(i === 7 || i !== i) n += 10000;
+    }
+    ok(n === 19015, "n = " + n);
+
+    n = 0;
+    if(nan < 1 || nan >= 1) n = 1;
+    ok(n === 0, "NaN comparison jumped, n = " + n);
+    if(o < 2) n++;
+    ok(n === 101, "n = " + n + " after valueOf comparison");
+    if("a" < "b" && "10" > "9") n = -1;
+    ok(n === 101, "n = " + n + " after string comparison");
+
+    ok((1 < 2) === true, "1 < 2 is not true");
+    ok((3 <= 2) === false, "3 <= 2 is not false");
+    ok((1 < 2 ? "t" : "f") === "t", "1 < 2 ? t : f is not t");
+    ok(1 + 2 === 3, "1 + 2 !== 3");
+    ok(0.5 + 0.25 === 0.75, "0.5 + 0.25 !== 0.75");
+    ok("1" + 2 === "12", "\"1\" + 2 !== \"12\"");
+}
+
+testConditionJumps();
+
 ActiveXObject = 1;
 ok(ActiveXObject === 1, "ActiveXObject = " + ActiveXObject);
 
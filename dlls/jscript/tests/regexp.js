@@ -713,4 +713,40 @@ ok(re.ignoreCase === false, "re.ignoreCase = " + re.ignoreCase);
 ok(re.multiline === true, "re.multiline = " + re.multiline);
 ok(re.global === true, "re.global = " + re.global);
 
+function testLiteralPrefix() {
+    var re, m, s;
+
+    m = "xx foo(bar) foo(baz)".match(/(foo)\((ba.)\)/g);
+    ok(m.length === 2, "m.length = " + m.length);
+    ok(m[1] === "foo(baz)", "m[1] = " + m[1]);
+
+    m = /(f)(o)o/.exec("fo fo foo");
+    ok(m.index === 6, "m.index = " + m.index);
+    ok(m[2] === "o", "m[2] = " + m[2]);
+
+    m = /FOO/i.exec("xfOo");
+    ok(m.index === 1, "m.index = " + m.index);
+    ok(m[0] === "fOo", "m[0] = " + m[0]);
+
+    ok(/abcdefghijklmnopqrstuvwxyz/.test("-abcdefghijklmnopqrstuvwxyz"), "long prefix not found");
+    ok(!/abcdefghijklmnopqrstuvwxyz/.test("-abcdefghijklmnopqrstuvwxy"), "long prefix found");
+    ok(/\x41\u0142b/.test("xxA\u0142b"), "escaped prefix not found");
+    ok(!/ab/.test("aaaaaaaaaaaaaaaaa"), "prefix found");
+    ok(/ab/.test("aaaaaaaaaaaaaaaab"), "prefix not found at the end");
+    ok(!/ab/.test("aaaaaaaaaaaaaaaa"), "prefix found past the end");
+
+    re = /ab/g;
+    re.lastIndex = 4;
+    m = re.exec("ab ab ab");
+    ok(m.index === 6, "m.index = " + m.index);
+    ok(re.lastIndex === 8, "re.lastIndex = " + re.lastIndex);
+
+    s = "a.b.c".replace(".", "-");
+    ok(s === "a-b.c", "s = " + s);
+    s = "a.b.c".split(".").join("");
+    ok(s === "abc", "s = " + s);
+}
+
+testLiteralPrefix();
+
 reportSuccess();
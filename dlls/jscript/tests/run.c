@@ -727,6 +727,42 @@ static IDispatchExVtbl pureDispVtbl = {
 
 static IDispatchEx pureDisp = { &pureDispVtbl };
 
+static LONG ref_obj_ref;
+
+static HRESULT WINAPI RefObj_QueryInterface(IDispatchEx *iface, REFIID riid, void **ppv)
+{
+    if(IsEqualGUID(riid, &IID_IUnknown) || IsEqualGUID(riid, &IID_IDispatch)) {
+        *ppv = iface;
+        IDispatchEx_AddRef(iface);
+        return S_OK;
+    }
+
+    *ppv = NULL;
+    return E_NOINTERFACE;
+}
+
+static ULONG WINAPI RefObj_AddRef(IDispatchEx *iface)
+{
+    return InterlockedIncrement(&ref_obj_ref);
+}
+
+static ULONG WINAPI RefObj_Release(IDispatchEx *iface)
+{
+    return InterlockedDecrement(&ref_obj_ref);
+}
+
+static IDispatchExVtbl RefObjVtbl = {
+    RefObj_QueryInterface,
+    RefObj_AddRef,
+    RefObj_Release,
+    DispatchEx_GetTypeInfoCount,
+    DispatchEx_GetTypeInfo,
+    DispatchEx_GetIDsOfNames,
+    DispatchEx_Invoke
+};
+
+static IDispatchEx refObj = { &RefObjVtbl };
+
 static HRESULT WINAPI BindEventHandler_QueryInterface(IBindEventHandler *iface, REFIID riid, void **ppv)
 {
     ok(0, "unexpected call\n");
@@ -2836,6 +2872,54 @@ static void test_invokeex(void)
     IActiveScript_Release(script);
 }
 
+static void test_gc(void)
+{
+    IActiveScriptParse *parser;
+    IActiveScript *engine;
+    DISPPARAMS dp = {NULL};
+    VARIANT v, arg;
+    HRESULT hres;
+
+    /* The object is only referenced by a cycle after the call returns. */
+    hres = parse_script_expr(L"(function(obj) { var o = {obj: obj, f: function() { return o; }}; o.self = o; })",
+                             &v, &engine);
+    ok(hres == S_OK, "parse_script_expr failed: %08x\n", hres);
+    ok(V_VT(&v) == VT_DISPATCH, "V_VT(v) = %d\n", V_VT(&v));
+
+    ref_obj_ref = 1;
+    V_VT(&arg) = VT_DISPATCH;
+    V_DISPATCH(&arg) = (IDispatch*)&refObj;
+    dp.rgvarg = &arg;
+    dp.cArgs = 1;
+    hres = IDispatch_Invoke(V_DISPATCH(&v), DISPID_VALUE, &IID_NULL, 0, DISPATCH_METHOD, &dp, NULL, NULL, NULL);
+    ok(hres == S_OK, "Invoke failed: %08x\n", hres);
+    VariantClear(&v);
+    ok(ref_obj_ref > 1, "ref_obj_ref = %d\n", ref_obj_ref);
+
+    hres = IActiveScript_QueryInterface(engine, &IID_IActiveScriptParse, (void**)&parser);
+    ok(hres == S_OK, "Could not get IActiveScriptParse: %08x\n", hres);
+
+    hres = IActiveScriptParse_ParseScriptText(parser, L"CollectGarbage();", NULL, NULL, NULL, 0, 0, 0, NULL, NULL);
+    ok(hres == S_OK, "ParseScriptText failed: %08x\n", hres);
+    ok(ref_obj_ref == 1, "ref_obj_ref = %d\n", ref_obj_ref);
+
+    IActiveScriptParse_Release(parser);
+    close_script(engine);
+
+    /* Cycles left at the time the script is closed are released as well. */
+    hres = parse_script_expr(L"(function(obj) { var o = {obj: obj}; o.self = o; })", &v, &engine);
+    ok(hres == S_OK, "parse_script_expr failed: %08x\n", hres);
+    ok(V_VT(&v) == VT_DISPATCH, "V_VT(v) = %d\n", V_VT(&v));
+
+    ref_obj_ref = 1;
+    hres = IDispatch_Invoke(V_DISPATCH(&v), DISPID_VALUE, &IID_NULL, 0, DISPATCH_METHOD, &dp, NULL, NULL, NULL);
+    ok(hres == S_OK, "Invoke failed: %08x\n", hres);
+    VariantClear(&v);
+
+    close_script(engine);
+    ok(ref_obj_ref == 1, "ref_obj_ref = %d\n", ref_obj_ref);
+}
+
 static void test_eval(void)
 {
     IActiveScriptParse *parser;
@@ -3344,6 +3428,7 @@ static BOOL run_tests(void)
 
     test_script_exprs();
     test_invokeex();
+    test_gc();
     test_eval();
     test_error_reports();
 
@@ -3494,6 +3579,11 @@ static void run_benchmarks(void)
     run_benchmark("dna.js");
     run_benchmark("base64.js");
     run_benchmark("validateinput.js");
+    run_benchmark("propaccess.js");
+    run_benchmark("calls.js");
+    run_benchmark("closures.js");
+    run_benchmark("gc.js");
+    run_benchmark("regexpbench.js");
 }
 
 static BOOL check_jscript(void)
@@ -323,6 +323,18 @@ typedef struct tagMSIVIEWOPS
      */
     UINT (*delete)( struct tagMSIVIEW * );
 
+    /*
+     * find_matching_rows - iterates through rows that match a value
+     *
+     * The value is compared with the raw value returned by fetch_int, so
+     *  a string ID should be passed in for string columns and a biased
+     *  integer for integer columns. Rows are returned in ascending order.
+     * The handle is an input/output parameter that keeps track of the current
+     *  position in the iteration. It must be initialised to zero before the
+     *  first call and continued to be passed in to subsequent calls.
+     */
+    UINT (*find_matching_rows)( struct tagMSIVIEW *view, UINT col, UINT val, UINT *row, MSIITERHANDLE *handle );
+
     /*
      * add_ref - increases the reference count of the table
      */
@@ -55,6 +55,7 @@ typedef struct tagMSICOLUMNINFO
     UINT    type;
     UINT    offset;
     MSICOLUMNHASHENTRY **hash_table;
+    UINT    hash_size;
 } MSICOLUMNINFO;
 
 struct tagMSITABLE
@@ -1009,6 +1010,19 @@ typedef struct tagMSITABLEVIEW
     WCHAR          name[1];
 } MSITABLEVIEW;
 
+/* row numbers change when rows are added or removed, so the column
+ * indexes have to be rebuilt on the next lookup */
+static void reset_hash_tables( MSITABLEVIEW *tv )
+{
+    UINT i;
+
+    for (i = 0; i < tv->num_cols; i++)
+    {
+        msi_free( tv->columns[i].hash_table );
+        tv->columns[i].hash_table = NULL;
+    }
+}
+
 static UINT TABLE_fetch_int( struct tagMSIVIEW *view, UINT row, UINT col, UINT *val )
 {
     MSITABLEVIEW *tv = (MSITABLEVIEW*)view;
@@ -1542,6 +1556,7 @@ static UINT table_create_new_row( struct tagMSIVIEW *view, UINT *num, BOOL tempo
     (*data_persist_ptr)[*row_count] = !temporary;
 
     (*row_count)++;
+    reset_hash_tables( tv );
 
     return ERROR_SUCCESS;
 }
@@ -1773,12 +1788,7 @@ static UINT TABLE_delete_row( struct tagMSIVIEW *view, UINT row )
     num_rows = tv->table->row_count;
     tv->table->row_count--;
 
-    /* reset the hash tables */
-    for (i = 0; i < tv->num_cols; i++)
-    {
-        msi_free( tv->columns[i].hash_table );
-        tv->columns[i].hash_table = NULL;
-    }
+    reset_hash_tables( tv );
 
     for (i = row + 1; i < num_rows; i++)
     {
@@ -1941,6 +1951,81 @@ static UINT TABLE_delete( struct tagMSIVIEW *view )
     return ERROR_SUCCESS;
 }
 
+static UINT TABLE_find_matching_rows( struct tagMSIVIEW *view, UINT col,
+    UINT val, UINT *row, MSIITERHANDLE *handle )
+{
+    MSITABLEVIEW *tv = (MSITABLEVIEW*)view;
+    const MSICOLUMNHASHENTRY *entry;
+
+    TRACE("%p, %d, %u, %p\n", view, col, val, *handle);
+
+    if( !tv->table )
+        return ERROR_INVALID_PARAMETER;
+
+    if( (col==0) || (col > tv->num_cols) )
+        return ERROR_INVALID_PARAMETER;
+
+    if( !tv->columns[col-1].hash_table )
+    {
+        UINT i, hash_size;
+        UINT num_rows = tv->table->row_count;
+        MSICOLUMNHASHENTRY **hash_table;
+        MSICOLUMNHASHENTRY *new_entry;
+
+        if( tv->columns[col-1].offset >= tv->row_size )
+        {
+            ERR("Stuffed up %d >= %d\n", tv->columns[col-1].offset, tv->row_size );
+            ERR("%p %p\n", tv, tv->columns );
+            return ERROR_FUNCTION_FAILED;
+        }
+
+        /* keep the chains short for large tables */
+        hash_size = max( MSITABLE_HASH_TABLE_SIZE, num_rows | 1 );
+
+        /* allocate contiguous memory for the table and its entries so we
+         * don't have to do an expensive cleanup */
+        hash_table = msi_alloc_zero( hash_size * sizeof(MSICOLUMNHASHENTRY*) +
+                                     num_rows * sizeof(MSICOLUMNHASHENTRY) );
+        if (!hash_table)
+            return ERROR_OUTOFMEMORY;
+
+        new_entry = (MSICOLUMNHASHENTRY *)(hash_table + hash_size);
+
+        /* insert in reverse order so that each chain is sorted by row */
+        for (i = num_rows; i > 0; i--, new_entry++)
+        {
+            UINT row_value;
+
+            if (TABLE_fetch_int( view, i - 1, col, &row_value ) != ERROR_SUCCESS)
+                continue;
+
+            new_entry->value = row_value;
+            new_entry->row = i - 1;
+            new_entry->next = hash_table[row_value % hash_size];
+            hash_table[row_value % hash_size] = new_entry;
+        }
+
+        tv->columns[col-1].hash_table = hash_table;
+        tv->columns[col-1].hash_size = hash_size;
+    }
+
+    if( !*handle )
+        entry = tv->columns[col-1].hash_table[val % tv->columns[col-1].hash_size];
+    else
+        entry = (*handle)->next;
+
+    while (entry && entry->value != val)
+        entry = entry->next;
+
+    *handle = entry;
+    if (!entry)
+        return ERROR_NO_MORE_ITEMS;
+
+    *row = entry->row;
+
+    return ERROR_SUCCESS;
+}
+
 static UINT TABLE_add_ref(struct tagMSIVIEW *view)
 {
     MSITABLEVIEW *tv = (MSITABLEVIEW*)view;
@@ -1962,6 +2047,7 @@ static UINT TABLE_remove_column(struct tagMSIVIEW *view, UINT number)
     if (tv->table->colinfo[number-1].type & MSITYPE_TEMPORARY)
     {
         UINT size = tv->table->colinfo[number-1].offset;
+        msi_free( tv->table->colinfo[number-1].hash_table );
         tv->table->col_count--;
         tv->table->colinfo = msi_realloc( tv->table->colinfo, sizeof(*tv->table->colinfo) * tv->table->col_count );
 
@@ -2196,6 +2282,7 @@ static const MSIVIEWOPS table_ops =
     TABLE_get_column_info,
     TABLE_modify,
     TABLE_delete,
+    TABLE_find_matching_rows,
     TABLE_add_ref,
     TABLE_release,
     TABLE_add_column,
@@ -2774,6 +2861,7 @@ static const MSIVIEWOPS transform_view_ops =
     NULL,
     NULL,
     NULL,
+    NULL,
     NULL
 };
 
@@ -3161,11 +3249,35 @@ static UINT msi_row_matches( MSITABLEVIEW *tv, UINT row, const UINT *data, UINT
 
 static UINT msi_table_find_row( MSITABLEVIEW *tv, MSIRECORD *rec, UINT *row, UINT *column )
 {
-    UINT i, r = ERROR_FUNCTION_FAILED, *data;
+    MSIITERHANDLE handle = NULL;
+    UINT i, key, r = ERROR_FUNCTION_FAILED, *data;
 
     data = msi_record_to_row( tv, rec );
     if( !data )
         return r;
+
+    /* only rows matching the first key column can match the record */
+    for( key = 0; key < tv->num_cols; key++ )
+        if( tv->columns[key].type & MSITYPE_KEY )
+            break;
+
+    if( key < tv->num_cols &&
+        TABLE_find_matching_rows( &tv->view, key + 1, data[key], &i, &handle ) != ERROR_OUTOFMEMORY )
+    {
+        while( handle )
+        {
+            r = msi_row_matches( tv, i, data, column );
+            if( r == ERROR_SUCCESS )
+            {
+                *row = i;
+                break;
+            }
+            TABLE_find_matching_rows( &tv->view, key + 1, data[key], &i, &handle );
+        }
+        msi_free( data );
+        return r;
+    }
+
     for( i = 0; i < tv->table->row_count; i++ )
     {
         r = msi_row_matches( tv, i, data, column );
@@ -9304,6 +9304,152 @@ static void test_view_get_error(void)
     DeleteFileA(msifile);
 }
 
+static UINT count_rows(MSIHANDLE hdb, MSIHANDLE param, const char *query, UINT *count)
+{
+    MSIHANDLE view, rec;
+    UINT r;
+
+    *count = 0;
+    r = MsiDatabaseOpenViewA(hdb, query, &view);
+    if (r != ERROR_SUCCESS)
+        return r;
+    r = MsiViewExecute(view, param);
+    while (r == ERROR_SUCCESS && (r = MsiViewFetch(view, &rec)) == ERROR_SUCCESS)
+    {
+        MsiCloseHandle(rec);
+        (*count)++;
+    }
+    MsiViewClose(view);
+    MsiCloseHandle(view);
+    return r == ERROR_NO_MORE_ITEMS ? ERROR_SUCCESS : r;
+}
+
+static void test_where_index(void)
+{
+    static const struct
+    {
+        const char *query;
+        UINT count;
+    }
+    tests[] =
+    {
+        { "SELECT * FROM `T` WHERE `Key` = 'key42'", 1 },
+        { "SELECT * FROM `T` WHERE `Key` = 'missing'", 0 },
+        { "SELECT * FROM `T` WHERE `Key` = ''", 0 },
+        { "SELECT * FROM `T` WHERE 'key42' = `Key`", 1 },
+        { "SELECT * FROM `T` WHERE `Num` = 3", 20 },
+        { "SELECT * FROM `T` WHERE `Num` = 3 AND `Long` > 0", 10 },
+        { "SELECT * FROM `T` WHERE `Num` = 3 OR `Num` = 4", 40 },
+        { "SELECT * FROM `T` WHERE `Num` = 100000", 0 },
+        { "SELECT * FROM `T` WHERE `Long` = -5000", 1 },
+        { "SELECT * FROM `T` WHERE `Long` = 5000 AND `Num` = 5", 1 },
+        { "SELECT * FROM `T` WHERE `Long` = 5000 AND `Num` = 6", 0 },
+        { "SELECT * FROM `T`, `U` WHERE `T`.`Ref` = `U`.`Name`", 50 },
+        { "SELECT * FROM `T`, `U` WHERE `U`.`Name` = `T`.`Ref`", 50 },
+        { "SELECT * FROM `T`, `U` WHERE `T`.`Num` = `U`.`Value`", 200 },
+        { "SELECT * FROM `T`, `U` WHERE `T`.`Num` = `U`.`Value` AND `U`.`Name` = 'key7'", 20 },
+        { "SELECT * FROM `T`, `U` WHERE `T`.`Key` = 'key8' AND `T`.`Ref` = `U`.`Name`", 0 },
+        { "SELECT * FROM `T`, `U` WHERE `T`.`Key` = 'key1' AND `T`.`Ref` = `U`.`Name`", 1 },
+    };
+    MSIHANDLE hdb, rec;
+    char query[256];
+    DWORD start;
+    UINT i, r, count;
+
+    hdb = create_db();
+    ok(hdb, "failed to create db\n");
+
+    r = run_query(hdb, 0, "CREATE TABLE `T` (`Key` CHAR(32) NOT NULL, `Num` SHORT, "
+                          "`Long` LONG, `Ref` CHAR(32) PRIMARY KEY `Key`)");
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    r = run_query(hdb, 0, "CREATE TABLE `U` (`Name` CHAR(32) NOT NULL, `Value` SHORT PRIMARY KEY `Name`)");
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+
+    for (i = 0; i < 200; i++)
+    {
+        sprintf(query, "INSERT INTO `T` (`Key`, `Num`, `Long`, `Ref`) VALUES ('key%u', %u, %d, 'key%u')",
+                i, i % 10, ((int)i - 100) * 1000, (i * 7) % 200);
+        r = run_query(hdb, 0, query);
+        ok(r == ERROR_SUCCESS, "row %u: got %u\n", i, r);
+    }
+    for (i = 0; i < 50; i++)
+    {
+        sprintf(query, "INSERT INTO `U` (`Name`, `Value`) VALUES ('key%u', %u)", i, i);
+        r = run_query(hdb, 0, query);
+        ok(r == ERROR_SUCCESS, "row %u: got %u\n", i, r);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        r = count_rows(hdb, 0, tests[i].query, &count);
+        ok(r == ERROR_SUCCESS, "%s: got %u\n", tests[i].query, r);
+        ok(count == tests[i].count, "%s: got %u rows\n", tests[i].query, count);
+    }
+
+    r = do_query(hdb, "SELECT `Num`, `Long`, `Ref` FROM `T` WHERE `Key` = 'key42'", &rec);
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    check_record(rec, 3, "2", "-58000", "key94");
+    MsiCloseHandle(rec);
+
+    rec = MsiCreateRecord(1);
+    MsiRecordSetInteger(rec, 1, 3);
+    r = count_rows(hdb, rec, "SELECT * FROM `T` WHERE `Num` = ? AND `Key` = 'key13'", &count);
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    ok(count == 1, "got %u rows\n", count);
+    r = count_rows(hdb, rec, "SELECT * FROM `T` WHERE `Key` = 'key14' AND `Num` = ?", &count);
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    ok(count == 0, "got %u rows\n", count);
+    MsiCloseHandle(rec);
+
+    /* the key must stay unique */
+    r = run_query(hdb, 0, "INSERT INTO `T` (`Key`, `Num`, `Long`, `Ref`) VALUES ('key42', 1, 1, 'key1')");
+    ok(r == ERROR_FUNCTION_FAILED, "got %u\n", r);
+
+    /* rows move when the table changes */
+    r = run_query(hdb, 0, "INSERT INTO `T` (`Key`, `Num`, `Long`, `Ref`) VALUES ('key', 3, 0, 'key0')");
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    r = count_rows(hdb, 0, "SELECT * FROM `T` WHERE `Num` = 3", &count);
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    ok(count == 21, "got %u rows\n", count);
+
+    r = run_query(hdb, 0, "DELETE FROM `T` WHERE `Num` = 3");
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    r = count_rows(hdb, 0, "SELECT * FROM `T` WHERE `Num` = 3", &count);
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    ok(count == 0, "got %u rows\n", count);
+
+    r = run_query(hdb, 0, "UPDATE `T` SET `Num` = 3 WHERE `Key` = 'key42'");
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    r = do_query(hdb, "SELECT `Key` FROM `T` WHERE `Num` = 3", &rec);
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    check_record(rec, 1, "key42");
+    MsiCloseHandle(rec);
+
+    r = do_query(hdb, "SELECT `Num`, `Long`, `Ref` FROM `T` WHERE `Key` = 'key199'", &rec);
+    ok(r == ERROR_SUCCESS, "got %u\n", r);
+    check_record(rec, 3, "9", "99000", "key193");
+    MsiCloseHandle(rec);
+
+    if (winetest_interactive)
+    {
+        start = GetTickCount();
+        for (i = 0; i < 10000; i++)
+        {
+            sprintf(query, "SELECT * FROM `T` WHERE `Key` = 'key%u'", i % 200);
+            count_rows(hdb, 0, query, &count);
+        }
+        trace("10000 key lookups took %u ms\n", GetTickCount() - start);
+
+        start = GetTickCount();
+        for (i = 0; i < 100; i++)
+            count_rows(hdb, 0, "SELECT * FROM `T`, `U` WHERE `T`.`Ref` = `U`.`Name`", &count);
+        trace("100 joins took %u ms\n", GetTickCount() - start);
+    }
+
+    MsiCloseHandle(hdb);
+    DeleteFileA(msifile);
+}
+
 START_TEST(db)
 {
     test_msidatabase();
@@ -9363,4 +9509,5 @@ START_TEST(db)
     test_viewmodify_merge();
     test_viewmodify_insert();
     test_view_get_error();
+    test_where_index();
 }
@@ -646,15 +646,124 @@ static UINT WHERE_evaluate( MSIWHEREVIEW *wv, const UINT rows[],
     return ERROR_SUCCESS;
 }
 
+/* returns the raw value that the given column of the table has to match
+ * for the equality to be true, or FALSE if it can't be determined yet */
+static BOOL get_index_value( MSIWHEREVIEW *wv, const UINT rows[], const JOINTABLE *table,
+                             const struct expr *column, struct expr *value, UINT *col, UINT *val )
+{
+    INT ival;
+
+    switch (column->type)
+    {
+    case EXPR_COL_NUMBER:
+    case EXPR_COL_NUMBER32:
+    case EXPR_COL_NUMBER_STRING:
+        if (column->u.column.parsed.table != table)
+            return FALSE;
+        break;
+    default:
+        return FALSE;
+    }
+
+    switch (value->type)
+    {
+    case EXPR_UVAL:
+        if (column->type == EXPR_COL_NUMBER_STRING)
+            return FALSE;
+        ival = value->u.uval;
+        break;
+
+    case EXPR_COL_NUMBER:
+    case EXPR_COL_NUMBER32:
+        if (column->type == EXPR_COL_NUMBER_STRING ||
+            value->u.column.parsed.table == table ||
+            WHERE_evaluate( wv, rows, value, &ival, NULL ) != ERROR_SUCCESS)
+            return FALSE;
+        break;
+
+    case EXPR_COL_NUMBER_STRING:
+        if (column->type != EXPR_COL_NUMBER_STRING ||
+            value->u.column.parsed.table == table ||
+            expr_fetch_value( &value->u.column, rows, val ) != ERROR_SUCCESS)
+            return FALSE;
+        *col = column->u.column.parsed.column;
+        return TRUE;
+
+    case EXPR_SVAL:
+        if (column->type != EXPR_COL_NUMBER_STRING)
+            return FALSE;
+        /* null and empty strings compare equal */
+        if (!value->u.sval[0])
+            *val = 0;
+        /* a string that is not in the string table matches no row */
+        else if (msi_string2id( wv->db->strings, value->u.sval, -1, val ) != ERROR_SUCCESS)
+            *val = ~0u;
+        *col = column->u.column.parsed.column;
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+
+    /* undo the bias applied when the column is evaluated */
+    if (column->type == EXPR_COL_NUMBER)
+        *val = ival + 0x8000;
+    else
+        *val = ival + 0x80000000;
+    *col = column->u.column.parsed.column;
+    return TRUE;
+}
+
+/* looks for an equality that has to hold for the whole condition to be true
+ * and that restricts the rows of the table to the ones in a column index */
+static BOOL find_index_condition( MSIWHEREVIEW *wv, const UINT rows[], const JOINTABLE *table,
+                                  struct expr *cond, UINT *col, UINT *val )
+{
+    if (!cond)
+        return FALSE;
+
+    switch (cond->type)
+    {
+    case EXPR_COMPLEX:
+        if (cond->u.expr.op == OP_AND)
+            return find_index_condition( wv, rows, table, cond->u.expr.left, col, val ) ||
+                   find_index_condition( wv, rows, table, cond->u.expr.right, col, val );
+        /* fall through */
+    case EXPR_STRCMP:
+        if (cond->u.expr.op != OP_EQ)
+            return FALSE;
+        return get_index_value( wv, rows, table, cond->u.expr.left, cond->u.expr.right, col, val ) ||
+               get_index_value( wv, rows, table, cond->u.expr.right, cond->u.expr.left, col, val );
+    default:
+        return FALSE;
+    }
+}
+
 static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
                              UINT table_rows[] )
 {
-    UINT r = ERROR_FUNCTION_FAILED;
+    JOINTABLE *table = *tables;
+    UINT *row = &table_rows[table->table_index];
+    UINT r = ERROR_FUNCTION_FAILED, col, value;
+    MSIITERHANDLE handle = NULL;
+    BOOL indexed = FALSE;
     INT val;
 
-    for (table_rows[(*tables)->table_index] = 0;
-         table_rows[(*tables)->table_index] < (*tables)->row_count;
-         table_rows[(*tables)->table_index]++)
+    if (table->view->ops->find_matching_rows)
+        indexed = find_index_condition( wv, table_rows, table, wv->cond, &col, &value );
+
+    *row = 0;
+    if (indexed)
+    {
+        r = table->view->ops->find_matching_rows( table->view, col, value, row, &handle );
+        if (r == ERROR_NO_MORE_ITEMS)
+            *row = table->row_count;
+        else if (r != ERROR_SUCCESS)
+            indexed = FALSE;
+        r = ERROR_SUCCESS;
+    }
+
+    while (*row < table->row_count)
     {
         val = 0;
         wv->rec_index = 0;
@@ -676,8 +785,13 @@ static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **ta
                 add_row (wv, table_rows);
             }
         }
+
+        if (!indexed)
+            (*row)++;
+        else if (table->view->ops->find_matching_rows( table->view, col, value, row, &handle ) != ERROR_SUCCESS)
+            break;
     }
-    table_rows[(*tables)->table_index] = INVALID_ROW_INDEX;
+    *row = INVALID_ROW_INDEX;
     return r;
 }
 
@@ -1130,6 +1244,7 @@ static const MSIVIEWOPS where_ops =
     NULL,
     NULL,
     NULL,
+    NULL,
     WHERE_sort,
     NULL,
 };
@@ -171,7 +171,8 @@ struct SchedulerVtbl {
     void (__thiscall *RegisterShutdownEvent)(Scheduler*,HANDLE);
     void (__thiscall *Attach)(Scheduler*);
     /* CreateScheduleGroup */
-    /* ScheduleTask */
+    void* (__thiscall *CreateScheduleGroup)(Scheduler*);
+    void (__thiscall *ScheduleTask)(Scheduler*,void (__cdecl*)(void*),void*);
 };
 
 static int* (__cdecl *p_errno)(void);
@@ -782,6 +783,62 @@ static void test_reader_writer_lock(void)
     call_func1(preader_writer_lock_dtor, rw_lock);
 }
 
+struct rw_lock_contention
+{
+    char rw_lock[100];
+    LONG readers;
+    LONG writers;
+    LONG errors;
+    int counter;
+};
+
+static DWORD WINAPI rw_lock_contention_thread(void *arg)
+{
+    struct rw_lock_contention *data = arg;
+    int i;
+
+    for(i = 0; i < 1000; i++) {
+        if(i % 4) {
+            call_func1(preader_writer_lock_lock_read, data->rw_lock);
+            InterlockedIncrement(&data->readers);
+            if(data->writers) InterlockedIncrement(&data->errors);
+            InterlockedDecrement(&data->readers);
+            call_func1(preader_writer_lock_unlock, data->rw_lock);
+        } else {
+            call_func1(preader_writer_lock_lock, data->rw_lock);
+            if(InterlockedIncrement(&data->writers) != 1 || data->readers)
+                InterlockedIncrement(&data->errors);
+            data->counter++;
+            InterlockedDecrement(&data->writers);
+            call_func1(preader_writer_lock_unlock, data->rw_lock);
+        }
+    }
+    return 0;
+}
+
+static void test_reader_writer_lock_contention(void)
+{
+    struct rw_lock_contention data;
+    HANDLE threads[4];
+    int i;
+
+    memset(&data, 0, sizeof(data));
+    call_func1(preader_writer_lock_ctor, data.rw_lock);
+
+    for(i = 0; i < ARRAY_SIZE(threads); i++) {
+        threads[i] = CreateThread(NULL, 0, rw_lock_contention_thread, &data, 0, NULL);
+        ok(threads[i] != NULL, "CreateThread failed: %d\n", GetLastError());
+    }
+    WaitForMultipleObjects(ARRAY_SIZE(threads), threads, TRUE, INFINITE);
+    for(i = 0; i < ARRAY_SIZE(threads); i++)
+        CloseHandle(threads[i]);
+
+    ok(!data.errors, "lock was shared between a writer and another thread %d times\n", data.errors);
+    ok(data.counter == ARRAY_SIZE(threads) * 250, "counter = %d\n", data.counter);
+
+    call_func1(preader_writer_lock_dtor, data.rw_lock);
+}
+
 static void test__ReentrantBlockingLock(void)
 {
     _ReentrantBlockingLock rbl;
@@ -989,6 +1046,53 @@ static void test_Scheduler(void)
     call_func1(p_SchedulerPolicy_dtor, &policy);
 }
 
+struct schedule_task_data
+{
+    Scheduler *scheduler;
+    LONG count;
+    LONG failures;
+};
+
+static void __cdecl schedule_task_proc(void *arg)
+{
+    struct schedule_task_data *data = arg;
+
+    if (p_CurrentScheduler_Get() != data->scheduler || p_Context_Id() == -1)
+        InterlockedIncrement(&data->failures);
+    InterlockedIncrement(&data->count);
+}
+
+static void test_Scheduler_ScheduleTask(void)
+{
+    struct schedule_task_data data;
+    SchedulerPolicy policy;
+    HANDLE event;
+    DWORD ret;
+    int i;
+
+    call_func1(p_SchedulerPolicy_ctor, &policy);
+    call_func3(p_SchedulerPolicy_SetConcurrencyLimits, &policy, 1, 2);
+    data.scheduler = p_Scheduler_Create(&policy);
+    ok(data.scheduler != NULL, "Scheduler::Create() = NULL\n");
+    data.count = data.failures = 0;
+
+    event = CreateEventW(NULL, TRUE, FALSE, NULL);
+    call_func2(data.scheduler->vtable->RegisterShutdownEvent, data.scheduler, event);
+
+    for (i = 0; i < 100; i++)
+        call_func3(data.scheduler->vtable->ScheduleTask, data.scheduler, schedule_task_proc, &data);
+
+    /* queued tasks keep the scheduler alive */
+    call_func1(data.scheduler->vtable->Release, data.scheduler);
+    ret = WaitForSingleObject(event, 5000);
+    ok(ret == WAIT_OBJECT_0, "WaitForSingleObject returned %u\n", ret);
+    ok(data.count == 100, "count = %d\n", data.count);
+    ok(!data.failures, "failures = %d\n", data.failures);
+
+    CloseHandle(event);
+    call_func1(p_SchedulerPolicy_dtor, &policy);
+}
+
 static void test__memicmp(void)
 {
     static const char *s1 = "abc";
@@ -1113,6 +1217,7 @@ START_TEST(msvcr100)
 
     test_ExternalContextBase();
     test_Scheduler();
+    test_Scheduler_ScheduleTask();
     test_wmemcpy_s();
     test_wmemmove_s();
     test_fread_s();
@@ -1120,6 +1225,7 @@ START_TEST(msvcr100)
     test_atoi();
     test__SpinWait();
     test_reader_writer_lock();
+    test_reader_writer_lock_contention();
     test__ReentrantBlockingLock();
     test_event();
     test__memicmp();
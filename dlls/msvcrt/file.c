@@ -2816,15 +2816,30 @@ static int read_i(int fd, ioinfo *fdinfo, void *buf, unsigned int count)
         }
         else if (fdinfo->wxflag & WX_TEXT)
         {
-            DWORD i, j;
+            DWORD i, j, end = num_read;
+            char *p;
 
             if (bufstart[0]=='\n' && (!utf16 || bufstart[1]==0))
                 fdinfo->wxflag |= WX_READNL;
             else
                 fdinfo->wxflag &= ~WX_READNL;
 
+            if (!utf16 && (p = memchr(bufstart, 0x1a, num_read)))
+                end = p - bufstart;
+
             for (i=0, j=0; i<num_read; i+=1+utf16)
             {
+                /* copy runs of characters that don't need translation at once */
+                if (!utf16 && bufstart[i]!='\r' && i<end)
+                {
+                    DWORD len = ((p = memchr(bufstart+i, '\r', end-i)) ? p-bufstart : end) - i;
+
+                    if (i != j) memmove(bufstart+j, bufstart+i, len);
+                    i += len;
+                    j += len;
+                    if (i == num_read) break;
+                }
+
                 /* in text mode, a ctrl-z signals EOF */
                 if (bufstart[i]==0x1a && (!utf16 || bufstart[i+1]==0))
                 {
@@ -3493,9 +3508,8 @@ int CDECL MSVCRT__write(int fd, const void* buf, unsigned int count)
         if (!(info->exflag & (EF_UTF8|EF_UTF16)))
         {
             /* find number of \n */
-            for (nr_lf=0, i=0; i<count; i++)
-                if (s[i] == '\n')
-                    nr_lf++;
+            for (nr_lf=0, q=s; (q = memchr(q, '\n', s+count-q)); q++)
+                nr_lf++;
             if (nr_lf)
             {
                 size = count+nr_lf;
@@ -3503,9 +3517,15 @@ int CDECL MSVCRT__write(int fd, const void* buf, unsigned int count)
                 {
                     for (s = buf, i = 0, j = 0; i < count; i++)
                     {
-                        if (s[i] == '\n')
-                            p[j++] = '\r';
-                        p[j++] = s[i];
+                        const char *lf = memchr(s+i, '\n', count-i);
+                        unsigned int len = (lf ? lf-s : count) - i;
+
+                        memcpy(p+j, s+i, len);
+                        i += len;
+                        j += len;
+                        if (!lf) break;
+                        p[j++] = '\r';
+                        p[j++] = '\n';
                     }
                 }
                 else
@@ -3791,10 +3811,30 @@ char * CDECL MSVCRT_fgets(char *s, int size, MSVCRT_FILE* file)
 
   MSVCRT__lock_file(file);
 
-  while ((size >1) && (cc = MSVCRT__fgetc_nolock(file)) != MSVCRT_EOF && cc != '\n')
+  while (size > 1)
     {
+      /* copy up to the end of line directly from the buffer */
+      if (file->_cnt > 0)
+        {
+          int len = file->_cnt < size - 1 ? file->_cnt : size - 1;
+          char *nl = memchr(file->_ptr, '\n', len);
+
+          if (nl) len = nl - file->_ptr + 1;
+          memcpy(s, file->_ptr, len);
+          s += len;
+          size -= len;
+          file->_ptr += len;
+          file->_cnt -= len;
+          if (nl) break;
+          continue;
+        }
+
+      if ((cc = MSVCRT__fgetc_nolock(file)) == MSVCRT_EOF)
+        break;
       *s++ = (char)cc;
-      size --;
+      size--;
+      if (cc == '\n')
+        break;
     }
   if ((cc == MSVCRT_EOF) && (s == buf_start)) /* If nothing read, return 0*/
   {
@@ -3802,8 +3842,6 @@ char * CDECL MSVCRT_fgets(char *s, int size, MSVCRT_FILE* file)
     MSVCRT__unlock_file(file);
     return NULL;
   }
-  if ((cc != MSVCRT_EOF) && (size > 1))
-    *s++ = cc;
   *s = '\0';
   TRACE(":got %s\n", debugstr_a(buf_start));
   MSVCRT__unlock_file(file);
@@ -53,8 +53,237 @@ static unsigned int MSVCRT_amblksiz = 16;
 /* FIXME - According to documentation it should be 480 bytes, at runtime default is 0 */
 static MSVCRT_size_t MSVCRT_sbh_threshold = 0;
 
+/* Optional per-thread cache for small blocks, enabled by setting the
+ * WINE_MSVCRT_THREAD_CACHE environment variable.
+ *
+ * Blocks are carved from 64k slabs owned by a thread cache. Blocks freed by
+ * the owning thread go back to its free lists without locking, blocks freed
+ * by other threads are pushed to a lock-free list that the owner drains when
+ * it runs out of blocks. Caches of exited threads are reused by new threads.
+ *
+ * Slabs are committed in order from a single reserved range, so a pointer is
+ * known to belong to the cache from its address alone, before anything is
+ * read from it. Once the range is used up, allocations go to the heap. */
+#ifdef _WIN64
+#define TCACHE_ARENA_SIZE       0x10000000
+#else
+#define TCACHE_ARENA_SIZE       0x1000000
+#endif
+#define TCACHE_SLAB_SIZE        0x10000
+#define TCACHE_SLAB_HEADER_SIZE 64
+#define TCACHE_HEADER_SIZE      16
+#define TCACHE_MAX_SIZE         1024
+
+static const unsigned short tcache_class_sizes[] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256,
+    320, 384, 448, 512, 640, 768, 896, 1024
+};
+#define TCACHE_CLASS_COUNT ARRAY_SIZE(tcache_class_sizes)
+
+struct tcache_header
+{
+    MSVCRT_size_t size;          /* requested size, valid while allocated */
+    struct tcache_header *next;  /* next free block, valid while free */
+};
+
+struct thread_cache
+{
+    struct tcache_header *free_list[TCACHE_CLASS_COUNT];
+    struct tcache_header * volatile remote_free;
+    DWORD tid;
+    struct thread_cache *next_unused;
+};
+
+struct tcache_slab
+{
+    struct thread_cache *owner;
+    unsigned int size_class;
+};
+
+static DWORD tcache_tls_index = TLS_OUT_OF_INDEXES;
+static BYTE tcache_class_index[TCACHE_MAX_SIZE / 16 + 1];
+static struct thread_cache *tcache_unused;
+static char * volatile tcache_arena;
+static volatile DWORD_PTR tcache_arena_used;
+
+static CRITICAL_SECTION tcache_cs;
+static CRITICAL_SECTION_DEBUG tcache_cs_debug =
+{
+    0, 0, &tcache_cs,
+    { &tcache_cs_debug.ProcessLocksList, &tcache_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": tcache_cs") }
+};
+static CRITICAL_SECTION tcache_cs = { &tcache_cs_debug, -1, 0, 0, 0, 0 };
+
+static inline struct tcache_header *tcache_header_from_ptr(void *ptr)
+{
+    return (struct tcache_header *)((char *)ptr - TCACHE_HEADER_SIZE);
+}
+
+/* Returns the slab containing ptr, or NULL if ptr doesn't come from the thread cache. */
+static inline struct tcache_slab *tcache_get_slab(void *ptr)
+{
+    char *arena = tcache_arena;
+    DWORD_PTR offset;
+
+    if (!arena || !ptr)
+        return NULL;
+
+    offset = (char *)ptr - arena;
+    if (offset >= tcache_arena_used || (offset & (TCACHE_SLAB_SIZE - 1)) < TCACHE_SLAB_HEADER_SIZE)
+        return NULL;
+    return (struct tcache_slab *)(arena + (offset & ~(DWORD_PTR)(TCACHE_SLAB_SIZE - 1)));
+}
+
+static struct thread_cache *tcache_get(void)
+{
+    struct thread_cache *cache;
+    DWORD err = GetLastError();  /* need to preserve last error */
+
+    if (!(cache = TlsGetValue(tcache_tls_index)))
+    {
+        EnterCriticalSection(&tcache_cs);
+        if ((cache = tcache_unused))
+            tcache_unused = cache->next_unused;
+        LeaveCriticalSection(&tcache_cs);
+
+        if (!cache)
+            cache = HeapAlloc(heap, HEAP_ZERO_MEMORY, sizeof(*cache));
+        if (cache)
+        {
+            cache->tid = GetCurrentThreadId();
+            TlsSetValue(tcache_tls_index, cache);
+        }
+    }
+    SetLastError(err);
+    return cache;
+}
+
+static void tcache_drain_remote(struct thread_cache *cache)
+{
+    struct tcache_header *block, *next;
+    struct tcache_slab *slab;
+
+    block = InterlockedExchangePointer((void **)&cache->remote_free, NULL);
+    for (; block; block = next)
+    {
+        next = block->next;
+        slab = tcache_get_slab((char *)block + TCACHE_HEADER_SIZE);
+        block->next = cache->free_list[slab->size_class];
+        cache->free_list[slab->size_class] = block;
+    }
+}
+
+static BOOL tcache_add_slab(struct thread_cache *cache, unsigned int size_class)
+{
+    unsigned int stride = tcache_class_sizes[size_class] + TCACHE_HEADER_SIZE;
+    unsigned int count = (TCACHE_SLAB_SIZE - TCACHE_SLAB_HEADER_SIZE) / stride;
+    struct tcache_header *block;
+    struct tcache_slab *slab = NULL;
+
+    if (tcache_arena_used >= TCACHE_ARENA_SIZE)
+        return FALSE;
+
+    EnterCriticalSection(&tcache_cs);
+    if (!tcache_arena && !(tcache_arena = VirtualAlloc(NULL, TCACHE_ARENA_SIZE, MEM_RESERVE, PAGE_NOACCESS)))
+        tcache_arena_used = TCACHE_ARENA_SIZE;
+    if (tcache_arena_used < TCACHE_ARENA_SIZE)
+        slab = VirtualAlloc(tcache_arena + tcache_arena_used, TCACHE_SLAB_SIZE, MEM_COMMIT, PAGE_READWRITE);
+    if (slab)
+    {
+        slab->owner = cache;
+        slab->size_class = size_class;
+        tcache_arena_used += TCACHE_SLAB_SIZE;
+    }
+    LeaveCriticalSection(&tcache_cs);
+
+    if (!slab)
+        return FALSE;
+
+    while (count--)
+    {
+        block = (struct tcache_header *)((char *)slab + TCACHE_SLAB_HEADER_SIZE + count * stride);
+        block->next = cache->free_list[size_class];
+        cache->free_list[size_class] = block;
+    }
+    return TRUE;
+}
+
+static void *tcache_alloc(DWORD flags, MSVCRT_size_t size)
+{
+    unsigned int size_class = tcache_class_index[(size + 15) / 16];
+    struct thread_cache *cache;
+    struct tcache_header *block;
+    void *ptr;
+
+    if (!(cache = tcache_get()))
+        return NULL;
+
+    if (!cache->free_list[size_class])
+    {
+        tcache_drain_remote(cache);
+        if (!cache->free_list[size_class] && !tcache_add_slab(cache, size_class))
+            return NULL;
+    }
+
+    block = cache->free_list[size_class];
+    cache->free_list[size_class] = block->next;
+    block->size = size;
+
+    ptr = (char *)block + TCACHE_HEADER_SIZE;
+    if (flags & HEAP_ZERO_MEMORY)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
+static void tcache_free(struct tcache_slab *slab, void *ptr)
+{
+    struct tcache_header *block = tcache_header_from_ptr(ptr), *head;
+    struct thread_cache *owner = slab->owner;
+
+    if (owner->tid == GetCurrentThreadId())
+    {
+        block->next = owner->free_list[slab->size_class];
+        owner->free_list[slab->size_class] = block;
+        return;
+    }
+
+    do
+    {
+        head = owner->remote_free;
+        block->next = head;
+    } while (InterlockedCompareExchangePointer((void **)&owner->remote_free, block, head) != head);
+}
+
+static void tcache_init(void)
+{
+    char buffer[8];
+    unsigned int i, size_class = 0;
+
+    if (!GetEnvironmentVariableA("WINE_MSVCRT_THREAD_CACHE", buffer, sizeof(buffer)) || buffer[0] == '0')
+        return;
+
+    for (i = 0; i < ARRAY_SIZE(tcache_class_index); i++)
+    {
+        while (tcache_class_sizes[size_class] < i * 16)
+            size_class++;
+        tcache_class_index[i] = size_class;
+    }
+
+    tcache_tls_index = TlsAlloc();
+    TRACE("thread cache %s\n", tcache_tls_index == TLS_OUT_OF_INDEXES ? "failed" : "enabled");
+}
+
 static void* msvcrt_heap_alloc(DWORD flags, MSVCRT_size_t size)
 {
+    if(size <= TCACHE_MAX_SIZE && size >= MSVCRT_sbh_threshold &&
+            tcache_tls_index != TLS_OUT_OF_INDEXES)
+    {
+        void *ret = tcache_alloc(flags, size);
+        if(ret) return ret;
+    }
+
     if(size < MSVCRT_sbh_threshold)
     {
         void *memblock, *temp, **saved;
@@ -73,6 +302,29 @@ static void* msvcrt_heap_alloc(DWORD flags, MSVCRT_size_t size)
 
 static void* msvcrt_heap_realloc(DWORD flags, void *ptr, MSVCRT_size_t size)
 {
+    struct tcache_slab *slab;
+
+    if((slab = tcache_get_slab(ptr)))
+    {
+        struct tcache_header *block = tcache_header_from_ptr(ptr);
+        void *ret;
+
+        if(size <= tcache_class_sizes[slab->size_class])
+        {
+            block->size = size;
+            return ptr;
+        }
+        if(flags & HEAP_REALLOC_IN_PLACE_ONLY)
+            return NULL;
+
+        ret = msvcrt_heap_alloc(flags, size);
+        if(!ret) return NULL;
+
+        memcpy(ret, ptr, block->size);
+        tcache_free(slab, ptr);
+        return ret;
+    }
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         /* TODO: move data to normal heap if it exceeds sbh_threshold limit */
@@ -105,6 +357,14 @@ static void* msvcrt_heap_realloc(DWORD flags, void *ptr, MSVCRT_size_t size)
 
 static BOOL msvcrt_heap_free(void *ptr)
 {
+    struct tcache_slab *slab;
+
+    if((slab = tcache_get_slab(ptr)))
+    {
+        tcache_free(slab, ptr);
+        return TRUE;
+    }
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         void **saved = SAVED_PTR(ptr);
@@ -116,6 +376,9 @@ static BOOL msvcrt_heap_free(void *ptr)
 
 static MSVCRT_size_t msvcrt_heap_size(void *ptr)
 {
+    if(tcache_get_slab(ptr))
+        return tcache_header_from_ptr(ptr)->size;
+
     if(sb_heap && ptr && !HeapValidate(heap, 0, ptr))
     {
         void **saved = SAVED_PTR(ptr);
@@ -276,6 +539,11 @@ int CDECL _heapwalk(struct MSVCRT__heapinfo* next)
 
   if (sb_heap)
       FIXME("small blocks heap not supported\n");
+  if (tcache_tls_index != TLS_OUT_OF_INDEXES)
+  {
+      static int once;
+      if (!once++) FIXME("thread cache blocks not reported\n");
+  }
 
   LOCK_HEAP;
   phe.lpData = next->_pentry;
@@ -868,11 +1136,34 @@ int CDECL MSVCRT_strncpy_s(char *dest, MSVCRT_size_t numberOfElements,
 BOOL msvcrt_init_heap(void)
 {
     heap = HeapCreate(0, 0, 0);
+    if (heap) tcache_init();
     return heap != NULL;
 }
 
+/* Called on thread exit, leaves the thread cache to the next new thread. */
+void msvcrt_free_thread_cache(void)
+{
+    struct thread_cache *cache;
+
+    if (tcache_tls_index == TLS_OUT_OF_INDEXES || !(cache = TlsGetValue(tcache_tls_index)))
+        return;
+
+    TlsSetValue(tcache_tls_index, NULL);
+
+    EnterCriticalSection(&tcache_cs);
+    cache->tid = 0;
+    cache->next_unused = tcache_unused;
+    tcache_unused = cache;
+    LeaveCriticalSection(&tcache_cs);
+}
+
 void msvcrt_destroy_heap(void)
 {
+    if (tcache_arena)
+        VirtualFree(tcache_arena, 0, MEM_RELEASE);
+    if (tcache_tls_index != TLS_OUT_OF_INDEXES)
+        TlsFree(tcache_tls_index);
+
     HeapDestroy(heap);
     if(sb_heap)
         HeapDestroy(sb_heap);
@@ -280,7 +280,143 @@ MSVCRT_bool __thiscall SpinWait__SpinOnce(SpinWait *this)
     }
 }
 
-static HANDLE keyed_event;
+/* Keyed event replacement: a waiter and a releaser of the same key meet in
+ * a small hash table and then block on their own flag with RtlWaitOnAddress.
+ * This keeps contended waits in process instead of going through the server. */
+typedef struct key_wait
+{
+    const void *key;
+    BOOL release;
+    LONG signaled;
+    struct key_wait *next;
+} key_wait;
+
+#define KEY_WAIT_BUCKETS 64
+
+static struct
+{
+    LONG lock;
+    key_wait *head;
+} key_wait_table[KEY_WAIT_BUCKETS];
+
+/* moving average of the number of spins needed before being signaled */
+static LONG key_wait_spins = 100;
+
+static inline void small_pause(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__( "rep;nop" : : : "memory" );
+#else
+    __asm__ __volatile__( "" : : : "memory" );
+#endif
+}
+
+static inline unsigned int key_wait_hash(const void *key)
+{
+    ULONG_PTR k = (ULONG_PTR)key;
+    return (k ^ (k >> 6) ^ (k >> 12)) % KEY_WAIT_BUCKETS;
+}
+
+static void key_wait_lock(LONG *lock)
+{
+    unsigned int spin = 0;
+
+    while(InterlockedCompareExchange(lock, 1, 0)) {
+        while(*(volatile LONG*)lock) {
+            if(++spin % 64) small_pause();
+            else Sleep(0);
+        }
+    }
+}
+
+static inline void key_wait_unlock(LONG *lock)
+{
+    InterlockedExchange(lock, 0);
+}
+
+static BOOL key_wait_remove(unsigned int bucket, key_wait *wait)
+{
+    key_wait **prev;
+
+    for(prev = &key_wait_table[bucket].head; *prev; prev = &(*prev)->next) {
+        if(*prev == wait) {
+            *prev = wait->next;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void key_wait_spin(key_wait *wait)
+{
+    unsigned int i, max = SpinCount__Value();
+    LONG avg = key_wait_spins;
+
+    if(max > avg * 2 + 10) max = avg * 2 + 10;
+    for(i = 0; i < max; i++) {
+        if(wait->signaled) break;
+        small_pause();
+    }
+    if(max) InterlockedExchangeAdd(&key_wait_spins, ((LONG)i - avg) / 8);
+}
+
+static NTSTATUS key_wait_rendezvous(const void *key, BOOL release, const LARGE_INTEGER *timeout)
+{
+    unsigned int bucket = key_wait_hash(key);
+    key_wait wait, **prev, *cur;
+    LARGE_INTEGER abs_timeout;
+    LONG zero = FALSE;
+
+    key_wait_lock(&key_wait_table[bucket].lock);
+    for(prev = &key_wait_table[bucket].head; (cur = *prev); prev = &cur->next) {
+        if(cur->key != key || cur->release == release) continue;
+
+        *prev = cur->next;
+        key_wait_unlock(&key_wait_table[bucket].lock);
+        InterlockedExchange(&cur->signaled, TRUE);
+        RtlWakeAddressSingle(&cur->signaled);
+        return STATUS_WAIT_0;
+    }
+
+    wait.key = key;
+    wait.release = release;
+    wait.signaled = FALSE;
+    wait.next = NULL;
+    *prev = &wait;
+    key_wait_unlock(&key_wait_table[bucket].lock);
+
+    if(timeout && timeout->QuadPart < 0) {
+        NtQuerySystemTime(&abs_timeout);
+        abs_timeout.QuadPart -= timeout->QuadPart;
+        timeout = &abs_timeout;
+    }
+
+    key_wait_spin(&wait);
+    while(!wait.signaled) {
+        if(RtlWaitOnAddress(&wait.signaled, &zero, sizeof(zero), timeout) != STATUS_TIMEOUT)
+            continue;
+
+        key_wait_lock(&key_wait_table[bucket].lock);
+        if(key_wait_remove(bucket, &wait)) {
+            key_wait_unlock(&key_wait_table[bucket].lock);
+            return STATUS_TIMEOUT;
+        }
+        key_wait_unlock(&key_wait_table[bucket].lock);
+        /* we've been dequeued, the signal is on its way */
+        timeout = NULL;
+    }
+    return STATUS_WAIT_0;
+}
+
+static inline NTSTATUS wait_for_key(const void *key, const LARGE_INTEGER *timeout)
+{
+    return key_wait_rendezvous(key, FALSE, timeout);
+}
+
+static inline void release_key(const void *key)
+{
+    key_wait_rendezvous(key, TRUE, NULL);
+}
 
 /* keep in sync with msvcp90/msvcp90.h */
 typedef struct cs_queue
@@ -312,14 +448,6 @@ critical_section* __thiscall critical_section_ctor(critical_section *this)
 {
     TRACE("(%p)\n", this);
 
-    if(!keyed_event) {
-        HANDLE event;
-
-        NtCreateKeyedEvent(&event, GENERIC_READ|GENERIC_WRITE, NULL, 0);
-        if(InterlockedCompareExchangePointer(&keyed_event, event, NULL) != NULL)
-            NtClose(event);
-    }
-
     this->unk_thread_id = 0;
     this->head = this->tail = NULL;
     return this;
@@ -369,7 +497,7 @@ static inline void cs_lock(critical_section *cs, cs_queue *q)
     last = InterlockedExchangePointer(&cs->tail, q);
     if(last) {
         last->next = q;
-        NtWaitForKeyedEvent(keyed_event, q, 0, NULL);
+        wait_for_key(q, NULL);
     }
 
     cs_set_head(cs, q);
@@ -446,7 +574,7 @@ void __thiscall critical_section_unlock(critical_section *this)
     }
 #endif
 
-    NtReleaseKeyedEvent(keyed_event, this->unk_active.next, 0, NULL);
+    release_key(this->unk_active.next);
 }
 
 /* ?native_handle@critical_section@Concurrency@@QAEAAV12@XZ */
@@ -485,13 +613,13 @@ MSVCRT_bool __thiscall critical_section_try_lock_for(
         GetSystemTimeAsFileTime(&ft);
         to.QuadPart = ((LONGLONG)ft.dwHighDateTime<<32) +
             ft.dwLowDateTime + (LONGLONG)timeout*10000;
-        status = NtWaitForKeyedEvent(keyed_event, q, 0, &to);
+        status = wait_for_key(q, &to);
         if(status == STATUS_TIMEOUT) {
             if(!InterlockedExchange(&q->free, TRUE))
                 return FALSE;
             /* A thread has signaled the event and is block waiting. */
             /* We need to catch the event to wake the thread.        */
-            NtWaitForKeyedEvent(keyed_event, q, 0, NULL);
+            wait_for_key(q, NULL);
         }
     }
 
@@ -810,10 +938,10 @@ static MSVCRT_size_t evt_wait(thread_wait *wait, event **events, int count, MSVC
     if(!evt_transition(&wait->signaled, EVT_RUNNING, EVT_WAITING))
         return evt_end_wait(wait, events, count);
 
-    status = NtWaitForKeyedEvent(keyed_event, wait, 0, evt_timeout(&ntto, timeout));
+    status = wait_for_key(wait, evt_timeout(&ntto, timeout));
 
     if(status && !evt_transition(&wait->signaled, EVT_WAITING, EVT_RUNNING))
-        NtWaitForKeyedEvent(keyed_event, wait, 0, NULL);
+        wait_for_key(wait, NULL);
 
     return evt_end_wait(wait, events, count);
 }
@@ -889,7 +1017,7 @@ void __thiscall event_set(event *this)
     for(entry=wakeup; entry; entry=next) {
         next = entry->next;
         entry->next = entry->prev = NULL;
-        NtReleaseKeyedEvent(keyed_event, entry->wait, 0, NULL);
+        release_key(entry->wait);
     }
 }
 
@@ -990,7 +1118,7 @@ void __thiscall _Condition_variable_wait(_Condition_variable *this, critical_sec
     critical_section_unlock(&this->lock);
 
     critical_section_unlock(cs);
-    NtWaitForKeyedEvent(keyed_event, &q, 0, NULL);
+    wait_for_key(&q, NULL);
     critical_section_lock(cs);
 }
 
@@ -1022,14 +1150,14 @@ MSVCRT_bool __thiscall _Condition_variable_wait_for(_Condition_variable *this,
     GetSystemTimeAsFileTime(&ft);
     to.QuadPart = ((LONGLONG)ft.dwHighDateTime << 32) +
         ft.dwLowDateTime + (LONGLONG)timeout * 10000;
-    status = NtWaitForKeyedEvent(keyed_event, q, 0, &to);
+    status = wait_for_key(q, &to);
     if(status == STATUS_TIMEOUT) {
         if(!InterlockedExchange(&q->expired, TRUE)) {
             critical_section_lock(cs);
             return FALSE;
         }
         else
-            NtWaitForKeyedEvent(keyed_event, q, 0, 0);
+            wait_for_key(q, NULL);
     }
 
     HeapFree(GetProcessHeap(), 0, q);
@@ -1060,7 +1188,7 @@ void __thiscall _Condition_variable_notify_one(_Condition_variable *this)
         critical_section_unlock(&this->lock);
 
         if(!InterlockedExchange(&node->expired, TRUE)) {
-            NtReleaseKeyedEvent(keyed_event, node, 0, NULL);
+            release_key(node);
             return;
         } else {
             HeapFree(GetProcessHeap(), 0, node);
@@ -1089,7 +1217,7 @@ void __thiscall _Condition_variable_notify_all(_Condition_variable *this)
         cv_queue *next = ptr->next;
 
         if(!InterlockedExchange(&ptr->expired, TRUE))
-            NtReleaseKeyedEvent(keyed_event, ptr, 0, NULL);
+            release_key(ptr);
         else
             HeapFree(GetProcessHeap(), 0, ptr);
         ptr = next;
@@ -1123,14 +1251,6 @@ reader_writer_lock* __thiscall reader_writer_lock_ctor(reader_writer_lock *this)
 {
     TRACE("(%p)\n", this);
 
-    if (!keyed_event) {
-        HANDLE event;
-
-        NtCreateKeyedEvent(&event, GENERIC_READ|GENERIC_WRITE, NULL, 0);
-        if (InterlockedCompareExchangePointer(&keyed_event, event, NULL) != NULL)
-            NtClose(event);
-    }
-
     memset(this, 0, sizeof(*this));
     return this;
 }
@@ -1193,11 +1313,11 @@ void __thiscall reader_writer_lock_lock(reader_writer_lock *this)
     last = InterlockedExchangePointer((void**)&this->writer_tail, &q);
     if (last) {
         last->next = &q;
-        NtWaitForKeyedEvent(keyed_event, &q, 0, NULL);
+        wait_for_key(&q, NULL);
     } else {
         this->writer_head = &q;
         if (InterlockedOr(&this->count, WRITER_WAITING))
-            NtWaitForKeyedEvent(keyed_event, &q, 0, NULL);
+            wait_for_key(&q, NULL);
     }
 
     this->thread_id = GetCurrentThreadId();
@@ -1232,18 +1352,28 @@ void __thiscall reader_writer_lock_lock_read(reader_writer_lock *this)
         while (!((count = this->count) & WRITER_WAITING))
             if (InterlockedCompareExchange(&this->count, count+1, count) == count) break;
 
-        if (count & WRITER_WAITING)
-            NtWaitForKeyedEvent(keyed_event, &q, 0, NULL);
+        /* whoever takes us off the reader queue counts and releases us */
+        if (count & WRITER_WAITING) {
+            wait_for_key(&q, NULL);
+            return;
+        }
 
         head = InterlockedExchangePointer((void**)&this->reader_head, NULL);
         while(head && head != &q) {
             rwl_queue *next = head->next;
             InterlockedIncrement(&this->count);
-            NtReleaseKeyedEvent(keyed_event, head, 0, NULL);
+            release_key(head);
             head = next;
         }
+
+        /* Somebody else has taken us off the queue after we've entered the
+         * lock. It has counted us once more and is waiting to release us. */
+        if (!head) {
+            wait_for_key(&q, NULL);
+            InterlockedDecrement(&this->count);
+        }
     } else {
-        NtWaitForKeyedEvent(keyed_event, &q, 0, NULL);
+        wait_for_key(&q, NULL);
     }
 }
 
@@ -1314,14 +1444,14 @@ void __thiscall reader_writer_lock_unlock(reader_writer_lock *this)
         count = InterlockedDecrement(&this->count);
         if (count != WRITER_WAITING)
             return;
-        NtReleaseKeyedEvent(keyed_event, this->writer_head, 0, NULL);
+        release_key(this->writer_head);
         return;
     }
 
     this->thread_id = 0;
     next = this->writer_head->next;
     if (next) {
-        NtReleaseKeyedEvent(keyed_event, next, 0, NULL);
+        release_key(next);
         return;
     }
     InterlockedAnd(&this->count, ~WRITER_WAITING);
@@ -1329,13 +1459,19 @@ void __thiscall reader_writer_lock_unlock(reader_writer_lock *this)
     while (head) {
         next = head->next;
         InterlockedIncrement(&this->count);
-        NtReleaseKeyedEvent(keyed_event, head, 0, NULL);
+        release_key(head);
         head = next;
     }
 
     if (InterlockedCompareExchangePointer((void**)&this->writer_tail, NULL, this->writer_head) == this->writer_head)
         return;
-    InterlockedOr(&this->count, WRITER_WAITING);
+
+    /* a writer has queued itself in the meantime, hand the lock over to it
+     * once the readers we've just released are done */
+    spin_wait_for_next_rwl(this->writer_head);
+    this->writer_head = this->writer_head->next;
+    if (!InterlockedOr(&this->count, WRITER_WAITING))
+        release_key(this->writer_head);
 }
 
 typedef struct {
@@ -1493,9 +1629,4 @@ void msvcrt_free_locks(void)
       msvcrt_uninitialize_mlock( i );
     }
   }
-
-#if _MSVCR_VER >= 100
-  if(keyed_event)
-      NtClose(keyed_event);
-#endif
 }
@@ -75,6 +75,8 @@ static inline void msvcrt_free_tls_mem(void)
     MSVCRT_free(tls->time_buffer);
     MSVCRT_free(tls->tmpnam_buffer);
     MSVCRT_free(tls->wtmpnam_buffer);
+    HeapFree(GetProcessHeap(), 0, tls->printf_cache_a);
+    HeapFree(GetProcessHeap(), 0, tls->printf_cache_w);
     if(tls->have_locale) {
         free_locinfo(tls->locinfo);
         free_mbcinfo(tls->mbcinfo);
@@ -150,6 +152,7 @@ BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved)
     break;
   case DLL_THREAD_DETACH:
     msvcrt_free_tls_mem();
+    msvcrt_free_thread_cache();
 #if _MSVCR_VER >= 100 && _MSVCR_VER <= 120
     msvcrt_free_scheduler_thread();
 #endif
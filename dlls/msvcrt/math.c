@@ -24,6 +24,7 @@
 #define __USE_ISOC9X 1
 #define __USE_ISOC99 1
 #include <math.h>
+#include <float.h>
 #ifdef HAVE_IEEEFP_H
 #include <ieeefp.h>
 #endif
@@ -141,6 +142,252 @@ int CDECL MSVCRT__set_FMA3_enable(int flag)
 # endif
 #endif
 
+/* Float kernels. They evaluate in double precision with small tables, which
+ * leaves enough headroom for the float result to be rounded correctly in
+ * nearly all cases. They only handle the common arguments; callers fall back
+ * to the host libm for everything else. */
+
+/* 2^(i/32) with i << 47 subtracted from the representation, so that adding
+ * k << 47 scales it by 2^(k/32 - i/32) */
+static const ULONGLONG math_exp2_table[32] =
+{
+    0x3ff0000000000000ULL, 0x3fefd9b0d3158574ULL, 0x3fefb5586cf9890fULL, 0x3fef9301d0125b51ULL,
+    0x3fef72b83c7d517bULL, 0x3fef54873168b9aaULL, 0x3fef387a6e756238ULL, 0x3fef1e9df51fdee1ULL,
+    0x3fef06fe0a31b715ULL, 0x3feef1a7373aa9cbULL, 0x3feedea64c123422ULL, 0x3feece086061892dULL,
+    0x3feebfdad5362a27ULL, 0x3feeb42b569d4f82ULL, 0x3feeab07dd485429ULL, 0x3feea47eb03a5585ULL,
+    0x3feea09e667f3bcdULL, 0x3fee9f75e8ec5f74ULL, 0x3feea11473eb0187ULL, 0x3feea589994cce13ULL,
+    0x3feeace5422aa0dbULL, 0x3feeb737b0cdc5e5ULL, 0x3feec49182a3f090ULL, 0x3feed503b23e255dULL,
+    0x3feee89f995ad3adULL, 0x3feeff76f2fb5e47ULL, 0x3fef199bdd85529cULL, 0x3fef3720dcef9069ULL,
+    0x3fef5818dcfba487ULL, 0x3fef7c97337b9b5fULL, 0x3fefa4afa2a490daULL, 0x3fefd0765b6e4540ULL
+};
+
+/* 1/c rounded to 28 bits, so that multiplying it by a float is exact, and
+ * ln(c) for the intervals of math_log_kernel */
+static const struct
+{
+    double invc;
+    double logc;
+} math_log_table[32] =
+{
+    { 1.414364643394947, -0.3466804149890704 },
+    { 1.3837837874889374, -0.32482162207879006 },
+    { 1.3544973582029343, -0.30343043215568016 },
+    { 1.3264248669147491, -0.2824872528971245 },
+    { 1.2994923889636993, -0.2619737181862957 },
+    { 1.2736318409442902, -0.24187253653690205 },
+    { 1.2487804889678955, -0.22216746627247688 },
+    { 1.2248803824186325, -0.20284319222371316 },
+    { 1.201877936720848, -0.1838852808074055 },
+    { 1.1797235012054443, -0.16528009000778035 },
+    { 1.1583710387349129, -0.14701474124468367 },
+    { 1.1377777755260468, -0.12907704029608186 },
+    { 1.117903932929039, -0.11145544342825224 },
+    { 1.09871244430542, -0.09413898905121676 },
+    { 1.0801687762141228, -0.07711730319891213 },
+    { 1.0622406601905823, -0.06038050749644782 },
+    { 1.0448979586362839, -0.04391923341096654 },
+    { 1.0281124487519264, -0.027724546996220793 },
+    { 1.0118577107787132, -0.011787958982567416 },
+    { 1.0, 0.0 },
+    { 0.9624060168862343, 0.03831886238128379 },
+    { 0.9343065693974495, 0.06795066185030009 },
+    { 0.9078014194965363, 0.0967296252943979 },
+    { 0.8827586211264133, 0.12470347800619212 },
+    { 0.8590604029595852, 0.15191604170569983 },
+    { 0.8366013057529926, 0.1784076591899443 },
+    { 0.8152866251766682, 0.20421554023543384 },
+    { 0.7950310558080673, 0.22937410118126114 },
+    { 0.7757575772702694, 0.2539152080310068 },
+    { 0.7573964484035969, 0.2778684527205823 },
+    { 0.7398843914270401, 0.3012613327900529 },
+    { 0.7231638431549072, 0.32411946679156683 }
+};
+
+/* e^x for -104 < x < 89 */
+static inline double math_exp_kernel(double x)
+{
+    static const double inv_ln2_n = 4.61662413084468283841e+01; /* 32/ln(2) */
+    static const double c1 = 2.16608493924982901946e-02; /* ln(2)/32 */
+    static const double c2 = 2.34596198202246798660e-04; /* c1^2/2 */
+    static const double c3 = 1.69385097243718210202e-06; /* c1^3/6 */
+    static const double c4 = 9.17256270182464301942e-09; /* c1^4/24 */
+    union { double d; ULONGLONG i; } scale;
+    double z, r, r2;
+    int k;
+
+    /* e^x = 2^(k/32) * 2^(r/32), |r| <= 0.5 */
+    z = x * inv_ln2_n;
+    k = (int)(z + (z < 0 ? -0.5 : 0.5));
+    r = z - k;
+    r2 = r * r;
+
+    scale.i = math_exp2_table[k & 31] + ((ULONGLONG)k << 47);
+    return scale.d * (1.0 + r * c1 + r2 * (c2 + r * c3 + r2 * c4));
+}
+
+/* ln(x) for positive, finite x */
+static inline double math_log_kernel(float x)
+{
+    static const double ln2 = 6.93147180559945286227e-01;
+    union { float f; DWORD i; } u;
+    double z, z2;
+    DWORD tmp;
+    int e = 0, i;
+
+    u.f = x;
+    if (u.i < 0x00800000)
+    {
+        /* subnormal */
+        u.f *= 8388608.0f;
+        e = -23;
+    }
+
+    /* x = 2^e * m, 0x3f330000 <= m < 2 * 0x3f330000 */
+    tmp = u.i - 0x3f330000;
+    e += (int)tmp >> 23;
+    i = (tmp >> 18) & 31;
+    u.i -= tmp & 0xff800000;
+
+    /* ln(m) = ln(c) + ln(1 + z), z = m/c - 1, |z| < 0.023 */
+    z = u.f * math_log_table[i].invc - 1.0;
+    z2 = z * z;
+    return e * ln2 + math_log_table[i].logc + z + z2 * (-1.0 / 2 + z * (1.0 / 3)
+            + z2 * (-1.0 / 4 + z * (1.0 / 5)) + z2 * z2 * (-1.0 / 6 + z * (1.0 / 7)));
+}
+
+/* sin(r) and cos(r) for |r| <= pi/4 */
+static inline double math_sin_kernel(double r)
+{
+    double z = r * r, w = z * z;
+
+    return r + r * z * (-1.0 / 6 + z * (1.0 / 120) + w * (-1.0 / 5040 + z * (1.0 / 362880))
+            + w * w * (-1.0 / 39916800 + z * (1.0 / 6227020800)));
+}
+
+static inline double math_cos_kernel(double r)
+{
+    double z = r * r, w = z * z;
+
+    return 1.0 + z * (-1.0 / 2 + z * (1.0 / 24) + w * (-1.0 / 720 + z * (1.0 / 40320))
+            + w * w * (-1.0 / 3628800 + z * (1.0 / 479001600)));
+}
+
+/* Reduces x to r + n*pi/2, |r| <= pi/4. Fails for |x| >= 2^20 and non-finite x. */
+static inline BOOL math_reduce_pio2f(float x, double *r, int *n)
+{
+    static const double inv_pio2 = 6.36619772367581382433e-01;
+    static const double pio2_hi = 1.57079632673412561417e+00; /* 0x3ff921fb54400000 */
+    static const double pio2_lo = 6.07710050650619224932e-11; /* pi/2 - pio2_hi */
+    double fn;
+
+    if (!(x > -1048576.0f && x < 1048576.0f)) return FALSE;
+
+    fn = (int)(x * inv_pio2 + (x < 0 ? -0.5 : 0.5));
+    *n = (int)fn;
+    *r = x - fn * pio2_hi - fn * pio2_lo;
+    return TRUE;
+}
+
+static inline float math_sinf_reduced(double r, int n)
+{
+    switch (n & 3)
+    {
+    case 0: return math_sin_kernel(r);
+    case 1: return math_cos_kernel(r);
+    case 2: return -math_sin_kernel(r);
+    default: return -math_cos_kernel(r);
+    }
+}
+
+/* The fast paths below return FALSE for the arguments the kernels don't
+ * handle, which leaves those to the host libm and the error handling. */
+static inline BOOL math_sinf_fast(float x, float *ret)
+{
+    double r;
+    int n;
+
+    if (!math_reduce_pio2f(x, &r, &n)) return FALSE;
+    *ret = math_sinf_reduced(r, n);
+    return TRUE;
+}
+
+static inline BOOL math_cosf_fast(float x, float *ret)
+{
+    double r;
+    int n;
+
+    if (!math_reduce_pio2f(x, &r, &n)) return FALSE;
+    *ret = math_sinf_reduced(r, n + 1);
+    return TRUE;
+}
+
+static inline BOOL math_expf_fast(float x, float *ret)
+{
+    /* no overflow or underflow to zero in this range */
+    if (!(x > -88.0f && x < 88.0f)) return FALSE;
+    *ret = math_exp_kernel(x);
+    return TRUE;
+}
+
+static inline BOOL math_logf_fast(float x, float *ret)
+{
+    if (!(x > 0 && x <= FLT_MAX)) return FALSE;
+    *ret = math_log_kernel(x);
+    return TRUE;
+}
+
+/* x^y for positive x and results that neither overflow nor underflow */
+static inline BOOL math_powf_fast(float x, float y, float *ret)
+{
+    double t;
+
+    if (!(x > 0 && x <= FLT_MAX && y >= -FLT_MAX && y <= FLT_MAX)) return FALSE;
+    t = y * math_log_kernel(x);
+    if (!(t > -88.0 && t < 88.0)) return FALSE;
+    *ret = math_exp_kernel(t);
+    return TRUE;
+}
+
+static inline float math_sinf(float x)
+{
+    float ret;
+
+    if (math_sinf_fast(x, &ret)) return ret;
+    return sinf(x);
+}
+
+static inline float math_cosf(float x)
+{
+    float ret;
+
+    if (math_cosf_fast(x, &ret)) return ret;
+    return cosf(x);
+}
+
+static inline float math_expf(float x)
+{
+    float ret;
+
+    if (math_expf_fast(x, &ret)) return ret;
+    return expf(x);
+}
+
+static inline float math_logf(float x)
+{
+    float ret;
+
+    if (math_logf_fast(x, &ret)) return ret;
+    return logf(x);
+}
+
+static inline float math_powf(float x, float y)
+{
+    float ret;
+
+    if (math_powf_fast(x, y, &ret)) return ret;
+    return powf(x, y);
+}
+
 #if !defined(__i386__) || _MSVCR_VER>=120
 
 /*********************************************************************
@@ -255,7 +502,10 @@ float CDECL MSVCRT_atan2f( float x, float y )
  */
 float CDECL MSVCRT_cosf( float x )
 {
-  float ret = cosf(x);
+  float ret;
+
+  if (math_cosf_fast(x, &ret)) return ret;
+  ret = cosf(x);
   if (!finitef(x)) math_error(_DOMAIN, "cosf", x, 0, ret);
   return ret;
 }
@@ -275,7 +525,10 @@ float CDECL MSVCRT_coshf( float x )
  */
 float CDECL MSVCRT_expf( float x )
 {
-  float ret = expf(x);
+  float ret;
+
+  if (math_expf_fast(x, &ret)) return ret;
+  ret = expf(x);
   if (isnan(x)) math_error(_DOMAIN, "expf", x, 0, ret);
   else if (finitef(x) && !ret) math_error(_UNDERFLOW, "expf", x, 0, ret);
   else if (finitef(x) && !finitef(ret)) math_error(_OVERFLOW, "expf", x, 0, ret);
@@ -297,7 +550,10 @@ float CDECL MSVCRT_fmodf( float x, float y )
  */
 float CDECL MSVCRT_logf( float x )
 {
-  float ret = logf(x);
+  float ret;
+
+  if (math_logf_fast(x, &ret)) return ret;
+  ret = logf(x);
   if (x < 0.0) math_error(_DOMAIN, "logf", x, 0, ret);
   else if (x == 0.0) math_error(_SING, "logf", x, 0, ret);
   return ret;
@@ -319,7 +575,10 @@ float CDECL MSVCRT_log10f( float x )
  */
 float CDECL MSVCRT_powf( float x, float y )
 {
-  float z = powf(x,y);
+  float z;
+
+  if (math_powf_fast(x, y, &z)) return z;
+  z = powf(x,y);
   if (x < 0 && y != floorf(y)) math_error(_DOMAIN, "powf", x, y, z);
   else if (!x && finitef(y) && y < 0) math_error(_SING, "powf", x, y, z);
   else if (finitef(x) && finitef(y) && !finitef(z)) math_error(_OVERFLOW, "powf", x, y, z);
@@ -332,7 +591,10 @@ float CDECL MSVCRT_powf( float x, float y )
  */
 float CDECL MSVCRT_sinf( float x )
 {
-  float ret = sinf(x);
+  float ret;
+
+  if (math_sinf_fast(x, &ret)) return ret;
+  ret = sinf(x);
   if (!finitef(x)) math_error(_DOMAIN, "sinf", x, 0, ret);
   return ret;
 }
@@ -2450,7 +2712,7 @@ void __cdecl MSVCRT___libm_sse2_cosf(void)
 {
     float f;
     __asm__ __volatile__( "movd %%xmm0,%0" : "=g" (f) );
-    f = cosf( f );
+    f = math_cosf( f );
     __asm__ __volatile__( "movd %0,%%xmm0" : : "g" (f) );
 }
 
@@ -2472,7 +2734,7 @@ void __cdecl MSVCRT___libm_sse2_expf(void)
 {
     float f;
     __asm__ __volatile__( "movd %%xmm0,%0" : "=g" (f) );
-    f = expf( f );
+    f = math_expf( f );
     __asm__ __volatile__( "movd %0,%%xmm0" : : "g" (f) );
 }
 
@@ -2516,7 +2778,7 @@ void __cdecl MSVCRT___libm_sse2_logf(void)
 {
     float f;
     __asm__ __volatile__( "movd %%xmm0,%0" : "=g" (f) );
-    f = logf( f );
+    f = math_logf( f );
     __asm__ __volatile__( "movd %0,%%xmm0" : : "g" (f) );
 }
 
@@ -2538,7 +2800,7 @@ void __cdecl MSVCRT___libm_sse2_powf(void)
 {
     float f1, f2;
     __asm__ __volatile__( "movd %%xmm0,%0; movd %%xmm1,%1" : "=g" (f1), "=g" (f2) );
-    f1 = powf( f1, f2 );
+    f1 = math_powf( f1, f2 );
     __asm__ __volatile__( "movd %0,%%xmm0" : : "g" (f1) );
 }
 
@@ -2560,7 +2822,7 @@ void __cdecl MSVCRT___libm_sse2_sinf(void)
 {
     float f;
     __asm__ __volatile__( "movd %%xmm0,%0" : "=g" (f) );
-    f = sinf( f );
+    f = math_sinf( f );
     __asm__ __volatile__( "movd %0,%%xmm0" : : "g" (f) );
 }
 
@@ -301,10 +301,52 @@ struct __thread_data {
 #if _MSVCR_VER >= 140
     MSVCRT_invalid_parameter_handler invalid_parameter_handler;
 #endif
+    void                           *printf_cache_a;     /* parsed printf format strings */
+    void                           *printf_cache_w;
 };
 
 typedef struct __thread_data thread_data_t;
 
+/* Helpers for scanning strings a machine word at a time. Aligned words never
+ * cross a page boundary, so reading past the terminator within a word is safe. */
+#define WORD_SIZE            sizeof(MSVCRT_size_t)
+#define WORD_BYTE_LOW_BITS   (~(MSVCRT_size_t)0 / 0xff)
+#define WORD_WCHAR_LOW_BITS  (~(MSVCRT_size_t)0 / 0xffff)
+
+static inline BOOL is_word_aligned(const void *ptr)
+{
+    return !((MSVCRT_size_t)ptr & (WORD_SIZE - 1));
+}
+
+static inline BOOL word_has_zero_byte(MSVCRT_size_t word)
+{
+    return ((word - WORD_BYTE_LOW_BITS) & ~word & (WORD_BYTE_LOW_BITS << 7)) != 0;
+}
+
+static inline BOOL word_has_zero_wchar(MSVCRT_size_t word)
+{
+    return ((word - WORD_WCHAR_LOW_BITS) & ~word & (WORD_WCHAR_LOW_BITS << 15)) != 0;
+}
+
+/* Returns the low 64 bits of a * b, and the high ones in *hi. */
+static inline ULONGLONG mul_64x64(ULONGLONG a, ULONGLONG b, ULONGLONG *hi)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *hi = r >> 64;
+    return r;
+#else
+    ULONGLONG ll = (ULONGLONG)(DWORD)a * (DWORD)b;
+    ULONGLONG lh = (ULONGLONG)(DWORD)a * (b >> 32);
+    ULONGLONG hl = (a >> 32) * (ULONGLONG)(DWORD)b;
+    ULONGLONG hh = (a >> 32) * (b >> 32);
+    ULONGLONG mid = (ll >> 32) + (DWORD)lh + (DWORD)hl;
+
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+    return (mid << 32) | (DWORD)ll;
+#endif
+}
+
 extern thread_data_t *msvcrt_get_thread_data(void) DECLSPEC_HIDDEN;
 
 LCID MSVCRT_locale_to_LCID(const char*, unsigned short*, BOOL*) DECLSPEC_HIDDEN;
@@ -374,6 +416,7 @@ extern void msvcrt_free_signals(void) DECLSPEC_HIDDEN;
 extern void msvcrt_free_popen_data(void) DECLSPEC_HIDDEN;
 extern BOOL msvcrt_init_heap(void) DECLSPEC_HIDDEN;
 extern void msvcrt_destroy_heap(void) DECLSPEC_HIDDEN;
+extern void msvcrt_free_thread_cache(void) DECLSPEC_HIDDEN;
 extern void msvcrt_init_clock(void) DECLSPEC_HIDDEN;
 
 #if _MSVCR_VER >= 100
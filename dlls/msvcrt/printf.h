@@ -30,6 +30,13 @@
 #define signbit(x) ((x) < 0)
 #endif
 
+#ifndef PF_NO_ARG
+#define PF_NO_ARG        (-2)
+#define PF_CACHE_ENTRIES 4
+#define PF_CACHE_SPECS   16
+#define PF_CACHE_LEN     128
+#endif
+
 typedef struct FUNC_NAME(pf_flags_t)
 {
     APICHAR Sign, LeftAlign, Alternate, PadZero;
@@ -39,6 +46,35 @@ typedef struct FUNC_NAME(pf_flags_t)
     APICHAR Format;
 } FUNC_NAME(pf_flags);
 
+/* A conversion specification, together with the literal text before it.
+ * Offsets are relative to the start of the format string. */
+typedef struct FUNC_NAME(pf_spec_t)
+{
+    int lit, lit_len;
+    BOOL conv;                    /* FALSE if there's only literal text */
+    int pos;                      /* argument position, -1 for the next one */
+    int width_arg, precision_arg; /* same for '*', or PF_NO_ARG */
+    FUNC_NAME(pf_flags) flags;
+} FUNC_NAME(pf_spec);
+
+/* Format strings are usually constants, so the parsed specifications are
+ * cached per thread and looked up by address. The text is kept to check
+ * that the string didn't change since it was parsed. */
+typedef struct FUNC_NAME(pf_cache_entry_t)
+{
+    const APICHAR *fmt;
+    DWORD options;
+    int count;
+    FUNC_NAME(pf_spec) specs[PF_CACHE_SPECS];
+    APICHAR text[PF_CACHE_LEN];
+} FUNC_NAME(pf_cache_entry);
+
+typedef struct FUNC_NAME(pf_cache_t)
+{
+    BOOL busy;
+    FUNC_NAME(pf_cache_entry) entries[PF_CACHE_ENTRIES];
+} FUNC_NAME(pf_cache);
+
 struct FUNC_NAME(_str_ctx) {
     MSVCRT_size_t len;
     APICHAR *buf;
@@ -93,15 +129,16 @@ static inline int FUNC_NAME(pf_fill)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ct
     written = r;
 
     if((!left && flags->LeftAlign) || (left && !flags->LeftAlign)) {
-        APICHAR ch;
+        APICHAR pad[32];
+        int count = flags->FieldLength-len, chunk;
 
-        if(left && flags->PadZero)
-            ch = '0';
-        else
-            ch = ' ';
+        /* output the padding in blocks instead of one character at a time */
+        chunk = count < (int)ARRAY_SIZE(pad) ? count : ARRAY_SIZE(pad);
+        for(i=0; i<chunk; i++)
+            pad[i] = left && flags->PadZero ? '0' : ' ';
 
-        for(i=0; i<flags->FieldLength-len && r>=0; i++) {
-            r = pf_puts(puts_ctx, 1, &ch);
+        for(; count>0 && r>=0; count-=chunk) {
+            r = pf_puts(puts_ctx, count < chunk ? count : chunk, pad);
             written += r;
         }
     }
@@ -144,6 +181,82 @@ static inline int mbstowcs_len(MSVCRT_wchar_t *wcstr, const char *mbstr,
     }
     return wlen;
 }
+
+/* pf_format_fixed: formats val, which must be finite and not negative, the same
+ * way as sprintf("%.*f") does with round to nearest. The exact value is
+ * scaled by 10^prec with integer arithmetic, so the result is correctly
+ * rounded. Returns -1 if the scaled value doesn't fit in 64 bits. */
+static inline int pf_format_fixed(char *buf, double val, int prec, BOOL alternate)
+{
+    union { double f; ULONGLONG i; } u = { val };
+    ULONGLONG mant = u.i & (((ULONGLONG)1 << 52) - 1), pow5 = 1, hi, lo;
+    ULONGLONG rem_hi, rem_lo, half_hi, half_lo, r;
+    int exp = (u.i >> 52) & 0x7ff, shift, len, i;
+    char digits[32];
+
+    if(prec < 0 || prec > 27)
+        return -1;
+
+    if(exp) {
+        mant |= (ULONGLONG)1 << 52;
+        exp -= 1075;
+    } else {
+        exp = -1074;
+    }
+
+    for(i=0; i<prec; i++)
+        pow5 *= 5;
+    lo = mul_64x64(mant, pow5, &hi);
+
+    /* val * 10^prec = mant * 5^prec * 2^(exp + prec) */
+    shift = exp + prec;
+    if(shift >= 0) {
+        if(hi || shift >= 64 || lo >> (63 - shift) >> 1)
+            return -1;
+        r = lo << shift;
+    } else if(-shift >= 128) {
+        r = 0;
+    } else {
+        shift = -shift;
+        if(shift < 64) {
+            if(hi >> shift)
+                return -1;
+            r = (lo >> shift) | (hi << (63 - shift) << 1);
+            rem_hi = 0;
+            rem_lo = lo & (((ULONGLONG)1 << shift) - 1);
+            half_hi = 0;
+            half_lo = (ULONGLONG)1 << (shift - 1);
+        } else {
+            r = hi >> (shift - 64);
+            rem_hi = hi & (((ULONGLONG)1 << (shift - 64)) - 1);
+            rem_lo = lo;
+            half_hi = shift > 64 ? (ULONGLONG)1 << (shift - 65) : 0;
+            half_lo = shift > 64 ? 0 : (ULONGLONG)1 << 63;
+        }
+
+        /* round half to even */
+        if(rem_hi > half_hi || (rem_hi == half_hi && (rem_lo > half_lo ||
+                        (rem_lo == half_lo && (r & 1))))) {
+            if(!++r)
+                return -1;
+        }
+    }
+
+    for(i=0; r; r/=10)
+        digits[i++] = '0' + r%10;
+    while(i <= prec)
+        digits[i++] = '0';
+
+    len = 0;
+    while(i > prec)
+        buf[len++] = digits[--i];
+    if(prec || alternate)
+        buf[len++] = '.';
+    while(i)
+        buf[len++] = digits[--i];
+    buf[len] = 0;
+    return len;
+}
 #endif
 
 static inline int FUNC_NAME(pf_output_wstr)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx,
@@ -173,7 +286,18 @@ static inline int FUNC_NAME(pf_output_str)(FUNC_NAME(puts_clbk) pf_puts, void *p
 {
 #ifdef PRINTF_WIDE
     LPWSTR out;
-    int len_w = mbstowcs_len(NULL, str, len, locale);
+    WCHAR buf[64];
+    int i, len_w;
+
+    /* ASCII strings (e.g. formatted numbers) don't need a code page conversion */
+    if(len <= (int)ARRAY_SIZE(buf)) {
+        for(i=0; i<len && !(str[i] & 0x80); i++)
+            buf[i] = str[i];
+        if(i == len)
+            return pf_puts(puts_ctx, len, buf);
+    }
+
+    len_w = mbstowcs_len(NULL, str, len, locale);
     if(len_w < 0)
         return -1;
 
@@ -564,6 +688,20 @@ static inline void FUNC_NAME(pf_integer_conv)(APICHAR *buf, int buf_len,
         flags->Alternate = 0;
         if(flags->Precision)
             buf[i++] = '0';
+    } else if(!((ULONGLONG)x >> 32)) {
+        /* avoid 64-bit divisions, and let the compiler optimize the constant ones */
+        unsigned int v = x;
+
+        if(base == 10) {
+            for(; v; v /= 10)
+                buf[i++] = digits[v % 10];
+        } else if(base == 16) {
+            for(; v; v >>= 4)
+                buf[i++] = digits[v & 15];
+        } else {
+            for(; v; v >>= 3)
+                buf[i++] = digits[v & 7];
+        }
     } else {
         while(x != 0) {
             j = (ULONGLONG)x%base;
@@ -630,155 +768,230 @@ static inline void FUNC_NAME(pf_fixup_exponent)(char *buf, BOOL three_digit_exp)
     }
 }
 
-int FUNC_NAME(pf_printf)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx, const APICHAR *fmt,
-        MSVCRT__locale_t locale, DWORD options,
-        args_clbk pf_args, void *args_ctx, __ms_va_list *valist)
+static inline BOOL FUNC_NAME(pf_is_conversion)(APICHAR ch)
 {
-    const APICHAR *q, *p = fmt;
-    APICHAR buf[32];
-    int written = 0, pos, i;
-    FUNC_NAME(pf_flags) flags;
+    return ch == 's' || ch == 'S' || ch == 'c' || ch == 'C' || ch == 'p' || ch == 'n' ||
+        (ch && strchr("diouxXaAeEfFgG", ch));
+}
+
+/* pf_parse_spec: parses the literal text at p and the conversion specification
+   following it, returns the position to continue parsing from */
+static const APICHAR* FUNC_NAME(pf_parse_spec)(const APICHAR *fmt, const APICHAR *p,
+        DWORD options, FUNC_NAME(pf_spec) *spec)
+{
+    const APICHAR *q;
+    int i;
     BOOL positional_params = options & MSVCRT_PRINTF_POSITIONAL_PARAMS;
-    BOOL invoke_invalid_param_handler = options & MSVCRT_PRINTF_INVOKE_INVALID_PARAM_HANDLER;
 #if _MSVCR_VER >= 140
-    BOOL legacy_wide = options & UCRTBASE_PRINTF_LEGACY_WIDE_SPECIFIERS;
     BOOL legacy_msvcrt_compat = options & UCRTBASE_PRINTF_LEGACY_MSVCRT_COMPATIBILITY;
-    BOOL three_digit_exp = options & UCRTBASE_PRINTF_LEGACY_THREE_DIGIT_EXPONENTS;
 #else
-    BOOL legacy_wide = TRUE, legacy_msvcrt_compat = TRUE, three_digit_exp = TRUE;
+    BOOL legacy_msvcrt_compat = TRUE;
 #endif
 
-    TRACE("Format is: %s\n", FUNC_NAME(debugstr)(fmt));
+    /* characters before '%' */
+    for(q=p; *q && *q!='%'; q++);
+    spec->lit = p - fmt;
+    spec->lit_len = q - p;
+    spec->conv = FALSE;
+    if(!*q)
+        return q;
+
+    /* a single '%' character is output with the text before it */
+    if(q[1] == '%') {
+        spec->lit_len++;
+        return q+2;
+    }
+    p = q+1;
+    spec->conv = TRUE;
 
-    if (!MSVCRT_CHECK_PMT(fmt != NULL))
-        return -1;
+    /* check parameter position */
+    if(positional_params && (q = FUNC_NAME(pf_parse_int)(p, &spec->pos)) && *q=='$')
+        p = q+1;
+    else
+        spec->pos = -1;
 
+    /* parse the flags */
+    memset(&spec->flags, 0, sizeof(spec->flags));
     while(*p) {
-        /* output characters before '%' */
-        for(q=p; *q && *q!='%'; q++);
-        if(p != q) {
-            i = pf_puts(puts_ctx, q-p, p);
-            if(i < 0)
-                return i;
-
-            written += i;
-            p = q;
-            continue;
-        }
+        if(*p=='+' || *p==' ') {
+            if(spec->flags.Sign != '+')
+                spec->flags.Sign = *p;
+        } else if(*p == '-')
+            spec->flags.LeftAlign = *p;
+        else if(*p == '0')
+            spec->flags.PadZero = *p;
+        else if(*p == '#')
+            spec->flags.Alternate = *p;
+        else
+            break;
 
-        /* *p == '%' here */
         p++;
+    }
 
-        /* output a single '%' character */
-        if(*p == '%') {
-            i = pf_puts(puts_ctx, 1, p++);
-            if(i < 0)
-                return i;
-
-            written += i;
-            continue;
-        }
-
-        /* check parameter position */
-        if(positional_params && (q = FUNC_NAME(pf_parse_int)(p, &pos)) && *q=='$')
+    /* parse the width */
+    spec->width_arg = PF_NO_ARG;
+    if(*p == '*') {
+        p++;
+        if(positional_params && (q = FUNC_NAME(pf_parse_int)(p, &i)) && *q=='$')
             p = q+1;
         else
-            pos = -1;
-
-        /* parse the flags */
-        memset(&flags, 0, sizeof(flags));
-        while(*p) {
-            if(*p=='+' || *p==' ') {
-                if(flags.Sign != '+')
-                    flags.Sign = *p;
-            } else if(*p == '-')
-                flags.LeftAlign = *p;
-            else if(*p == '0')
-                flags.PadZero = *p;
-            else if(*p == '#')
-                flags.Alternate = *p;
-            else
-                break;
-
-            p++;
-        }
+            i = -1;
+        spec->width_arg = i;
+    } else while(isdigit(*p)) {
+        spec->flags.FieldLength *= 10;
+        spec->flags.FieldLength += *p++ - '0';
+    }
 
-        /* parse the width */
+    /* parse the precision */
+    spec->flags.Precision = -1;
+    spec->precision_arg = PF_NO_ARG;
+    if(*p == '.') {
+        spec->flags.Precision = 0;
+        p++;
         if(*p == '*') {
             p++;
             if(positional_params && (q = FUNC_NAME(pf_parse_int)(p, &i)) && *q=='$')
                 p = q+1;
             else
                 i = -1;
-
-            flags.FieldLength = pf_args(args_ctx, i, VT_INT, valist).get_int;
-            if(flags.FieldLength < 0) {
-                flags.LeftAlign = '-';
-                flags.FieldLength = -flags.FieldLength;
-            }
+            spec->precision_arg = i;
         } else while(isdigit(*p)) {
-            flags.FieldLength *= 10;
-            flags.FieldLength += *p++ - '0';
+            spec->flags.Precision *= 10;
+            spec->flags.Precision += *p++ - '0';
         }
+    }
 
-        /* parse the precision */
-        flags.Precision = -1;
-        if(*p == '.') {
-            flags.Precision = 0;
+    /* parse argument size modifier */
+    while(*p) {
+        if(*p=='l' && *(p+1)=='l') {
+            spec->flags.IntegerDouble++;
+            p += 2;
+        } else if(*p=='h' || *p=='l' || *p=='L') {
+            spec->flags.IntegerLength = *p;
             p++;
-            if(*p == '*') {
-                p++;
-                if(positional_params && (q = FUNC_NAME(pf_parse_int)(p, &i)) && *q=='$')
-                    p = q+1;
-                else
-                    i = -1;
-
-                flags.Precision = pf_args(args_ctx, i, VT_INT, valist).get_int;
-            } else while(isdigit(*p)) {
-                flags.Precision *= 10;
-                flags.Precision += *p++ - '0';
-            }
-        }
-
-        /* parse argument size modifier */
-        while(*p) {
-            if(*p=='l' && *(p+1)=='l') {
-                flags.IntegerDouble++;
-                p += 2;
-            } else if(*p=='h' || *p=='l' || *p=='L') {
-                flags.IntegerLength = *p;
-                p++;
-            } else if(*p == 'I') {
-                if(*(p+1)=='6' && *(p+2)=='4') {
-                    flags.IntegerDouble++;
-                    p += 3;
-                } else if(*(p+1)=='3' && *(p+2)=='2')
-                    p += 3;
-                else if(p[1] && strchr("diouxX", p[1]))
-                    flags.IntegerNative = *p++;
-                else
-                    break;
-            } else if(*p == 'w')
-                flags.WideString = *p++;
+        } else if(*p == 'I') {
+            if(*(p+1)=='6' && *(p+2)=='4') {
+                spec->flags.IntegerDouble++;
+                p += 3;
+            } else if(*(p+1)=='3' && *(p+2)=='2')
+                p += 3;
+            else if(p[1] && strchr("diouxX", p[1]))
+                spec->flags.IntegerNative = *p++;
+            else
+                break;
+        } else if(*p == 'w')
+            spec->flags.WideString = *p++;
 #if _MSVCR_VER == 0 || _MSVCR_VER >= 140
-            else if((*p == 'z' || *p == 't') && p[1] && strchr("diouxX", p[1]))
-                flags.IntegerNative = *p++;
-            else if(*p == 'j') {
-                flags.IntegerDouble++;
-                p++;
-            }
+        else if((*p == 'z' || *p == 't') && p[1] && strchr("diouxX", p[1]))
+            spec->flags.IntegerNative = *p++;
+        else if(*p == 'j') {
+            spec->flags.IntegerDouble++;
+            p++;
+        }
 #endif
 #if _MSVCR_VER >= 140
-            else if(*p == 'T')
-                flags.NaturalString = *p++;
+        else if(*p == 'T')
+            spec->flags.NaturalString = *p++;
 #endif
-            else if((*p == 'F' || *p == 'N') && legacy_msvcrt_compat)
-                p++; /* ignore */
-            else
+        else if((*p == 'F' || *p == 'N') && legacy_msvcrt_compat)
+            p++; /* ignore */
+        else
+            break;
+    }
+
+    spec->flags.Format = *p;
+
+    /* unknown conversion characters are output as text */
+    return FUNC_NAME(pf_is_conversion)(*p) ? p+1 : p;
+}
+
+/* pf_get_cache_entry: returns the parsed specifications of fmt, or NULL if
+   it's too long to be cached */
+static FUNC_NAME(pf_cache_entry)* FUNC_NAME(pf_get_cache_entry)(FUNC_NAME(pf_cache) *cache,
+        const APICHAR *fmt, DWORD options)
+{
+    FUNC_NAME(pf_cache_entry) *entry;
+    const APICHAR *p;
+    int i;
+
+    entry = &cache->entries[((ULONG_PTR)fmt ^ ((ULONG_PTR)fmt >> 7)) % PF_CACHE_ENTRIES];
+    if(entry->fmt == fmt && entry->options == options) {
+        for(i=0; entry->text[i] == fmt[i]; i++)
+            if(!fmt[i])
+                return entry;
+    }
+
+    entry->fmt = NULL;
+    for(i=0; fmt[i]; i++) {
+        if(i == PF_CACHE_LEN-1)
+            return NULL;
+        entry->text[i] = fmt[i];
+    }
+    entry->text[i] = 0;
+
+    for(p=fmt, i=0; *p; i++) {
+        if(i == PF_CACHE_SPECS)
+            return NULL;
+        p = FUNC_NAME(pf_parse_spec)(fmt, p, options, &entry->specs[i]);
+    }
+    entry->fmt = fmt;
+    entry->options = options;
+    entry->count = i;
+    return entry;
+}
+
+static int FUNC_NAME(pf_printf_specs)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx, const APICHAR *fmt,
+        MSVCRT__locale_t locale, DWORD options, args_clbk pf_args, void *args_ctx,
+        __ms_va_list *valist, FUNC_NAME(pf_cache_entry) *entry)
+{
+    const APICHAR *p = fmt;
+    APICHAR buf[32];
+    int written = 0, pos, i, n;
+    FUNC_NAME(pf_spec) parsed, *spec;
+    FUNC_NAME(pf_flags) flags;
+    BOOL invoke_invalid_param_handler = options & MSVCRT_PRINTF_INVOKE_INVALID_PARAM_HANDLER;
+#if _MSVCR_VER >= 140
+    BOOL legacy_wide = options & UCRTBASE_PRINTF_LEGACY_WIDE_SPECIFIERS;
+    BOOL legacy_msvcrt_compat = options & UCRTBASE_PRINTF_LEGACY_MSVCRT_COMPATIBILITY;
+    BOOL three_digit_exp = options & UCRTBASE_PRINTF_LEGACY_THREE_DIGIT_EXPONENTS;
+#else
+    BOOL legacy_wide = TRUE, legacy_msvcrt_compat = TRUE, three_digit_exp = TRUE;
+#endif
+
+    for(n=0;; n++) {
+        if(entry) {
+            if(n == entry->count)
+                break;
+            spec = &entry->specs[n];
+        } else {
+            if(!*p)
                 break;
+            p = FUNC_NAME(pf_parse_spec)(fmt, p, options, &parsed);
+            spec = &parsed;
         }
 
-        flags.Format = *p;
+        if(spec->lit_len) {
+            i = pf_puts(puts_ctx, spec->lit_len, fmt + spec->lit);
+            if(i < 0)
+                return i;
+
+            written += i;
+        }
+        if(!spec->conv)
+            continue;
+
+        flags = spec->flags;
+        pos = spec->pos;
+
+        if(spec->width_arg != PF_NO_ARG) {
+            flags.FieldLength = pf_args(args_ctx, spec->width_arg, VT_INT, valist).get_int;
+            if(flags.FieldLength < 0) {
+                flags.LeftAlign = '-';
+                flags.FieldLength = -flags.FieldLength;
+            }
+        }
+        if(spec->precision_arg != PF_NO_ARG)
+            flags.Precision = pf_args(args_ctx, spec->precision_arg, VT_INT, valist).get_int;
 
         if(flags.Format == 's' || flags.Format == 'S') {
             i = FUNC_NAME(pf_handle_string)(pf_puts, puts_ctx,
@@ -883,9 +1096,14 @@ int FUNC_NAME(pf_printf)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx, const API
                 if(!tmp)
                     return -1;
 
-                FUNC_NAME(pf_rebuild_format_string)(float_fmt, &flags);
-
-                sprintf(tmp, float_fmt, val);
+                /* fixed notation can be done exactly without going through sprintf */
+                if((flags.Format!='f' && flags.Format!='F') ||
+                        (_control87(0, 0) & MSVCRT__MCW_RC) != MSVCRT__RC_NEAR ||
+                        pf_format_fixed(tmp, val, flags.Precision<0 ? 6 : flags.Precision,
+                            flags.Alternate) < 0) {
+                    FUNC_NAME(pf_rebuild_format_string)(float_fmt, &flags);
+                    sprintf(tmp, float_fmt, val);
+                }
                 if(MSVCRT__toupper_l(flags.Format, NULL)=='E' || MSVCRT__toupper_l(flags.Format, NULL)=='G')
                     FUNC_NAME(pf_fixup_exponent)(tmp, three_digit_exp);
 
@@ -921,12 +1139,42 @@ int FUNC_NAME(pf_printf)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx, const API
         if(i < 0)
             return i;
         written += i;
-        p++;
     }
 
     return written;
 }
 
+int FUNC_NAME(pf_printf)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx, const APICHAR *fmt,
+        MSVCRT__locale_t locale, DWORD options,
+        args_clbk pf_args, void *args_ctx, __ms_va_list *valist)
+{
+    thread_data_t *data;
+    FUNC_NAME(pf_cache) *cache;
+    FUNC_NAME(pf_cache_entry) *entry;
+    int ret;
+
+    TRACE("Format is: %s\n", FUNC_NAME(debugstr)(fmt));
+
+    if (!MSVCRT_CHECK_PMT(fmt != NULL))
+        return -1;
+
+    data = msvcrt_get_thread_data();
+    if(!(cache = data->FUNC_NAME(printf_cache)))
+        cache = data->FUNC_NAME(printf_cache) = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*cache));
+
+    /* nested calls, e.g. from the invalid parameter handler, parse the format themselves */
+    if(!cache || cache->busy)
+        return FUNC_NAME(pf_printf_specs)(pf_puts, puts_ctx, fmt, locale, options,
+                pf_args, args_ctx, valist, NULL);
+
+    cache->busy = TRUE;
+    entry = FUNC_NAME(pf_get_cache_entry)(cache, fmt, options);
+    ret = FUNC_NAME(pf_printf_specs)(pf_puts, puts_ctx, fmt, locale, options,
+            pf_args, args_ctx, valist, entry);
+    cache->busy = FALSE;
+    return ret;
+}
+
 #ifndef PRINTF_WIDE
 enum types_clbk_flags {
     TYPE_CLBK_VA_LIST = 1,
@@ -25,6 +25,7 @@
 #include "windef.h"
 #include "winternl.h"
 #include "wine/debug.h"
+#include "wine/list.h"
 #include "msvcrt.h"
 #include "cppexcept.h"
 #include "cxx.h"
@@ -89,6 +90,10 @@ typedef struct {
     struct scheduler_list scheduler;
     unsigned int id;
     union allocator_cache_entry *allocator_cache[8];
+    LONG blocked;
+    int oversubscribe;
+    /* set for contexts of scheduler worker threads */
+    struct Scheduler *worker_scheduler;
 } ExternalContextBase;
 extern const vtable_ptr MSVCRT_ExternalContextBase_vtable;
 static void ExternalContextBase_ctor(ExternalContextBase*);
@@ -130,6 +135,15 @@ typedef struct {
     int shutdown_size;
     HANDLE *shutdown_events;
     CRITICAL_SECTION cs;
+    /* protected by chore_cs */
+    struct list chores;
+    int chore_count;
+    CONDITION_VARIABLE chores_cond;
+    CONDITION_VARIABLE workers_cond;
+    int worker_count;
+    int idle_count;
+    int oversubscribed;
+    BOOL shutdown;
 } ThreadScheduler;
 extern const vtable_ptr MSVCRT_ThreadScheduler_vtable;
 
@@ -154,7 +168,26 @@ static CRITICAL_SECTION default_scheduler_cs = { &default_scheduler_cs_debug, -1
 static SchedulerPolicy default_scheduler_policy;
 static ThreadScheduler *default_scheduler;
 
+static CRITICAL_SECTION chore_cs;
+static CRITICAL_SECTION_DEBUG chore_cs_debug =
+{
+    0, 0, &chore_cs,
+    { &chore_cs_debug.ProcessLocksList, &chore_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": chore_cs") }
+};
+static CRITICAL_SECTION chore_cs = { &chore_cs_debug, -1, 0, 0, 0, 0 };
+
+/* worker threads exit after being idle for this long */
+#define SCHEDULER_WORKER_TIMEOUT 5000
+
+struct scheduler_chore {
+    struct list entry;
+    void (__cdecl *proc)(void*);
+    void *data;
+};
+
 static void create_default_scheduler(void);
+static void scheduler_oversubscribe(ExternalContextBase*, BOOL);
 
 static Context* try_get_current_context(void)
 {
@@ -163,22 +196,26 @@ static Context* try_get_current_context(void)
     return TlsGetValue(context_tls_index);
 }
 
-static Context* get_current_context(void)
+static void alloc_context_tls(void)
 {
-    Context *ret;
-
     if (context_tls_index == TLS_OUT_OF_INDEXES) {
         int tls_index = TlsAlloc();
         if (tls_index == TLS_OUT_OF_INDEXES) {
             throw_exception(EXCEPTION_SCHEDULER_RESOURCE_ALLOCATION_ERROR,
                     HRESULT_FROM_WIN32(GetLastError()), NULL);
-            return NULL;
+            return;
         }
 
         if(InterlockedCompareExchange(&context_tls_index, tls_index, TLS_OUT_OF_INDEXES) != TLS_OUT_OF_INDEXES)
             TlsFree(tls_index);
     }
+}
 
+static Context* get_current_context(void)
+{
+    Context *ret;
+
+    alloc_context_tls();
     ret = TlsGetValue(context_tls_index);
     if (!ret) {
         ExternalContextBase *context = MSVCRT_operator_new(sizeof(ExternalContextBase));
@@ -230,23 +267,48 @@ unsigned int __cdecl Context_Id(void)
     return ctx ? call_Context_GetId(ctx) : -1;
 }
 
+static ExternalContextBase* get_current_external_context(void)
+{
+    ExternalContextBase *context = (ExternalContextBase*)get_current_context();
+
+    if (context->context.vtable != &MSVCRT_ExternalContextBase_vtable) {
+        ERR("unknown context set\n");
+        return NULL;
+    }
+    return context;
+}
+
 /* ?Block@Context@Concurrency@@SAXXZ */
 void __cdecl Context_Block(void)
 {
-    FIXME("()\n");
+    ExternalContextBase *context = get_current_external_context();
+    LONG blocked;
+
+    TRACE("()\n");
+
+    if (!context || InterlockedDecrement(&context->blocked) >= 0)
+        return;
+
+    /* let another worker run chores while this one is blocked */
+    scheduler_oversubscribe(context, TRUE);
+    while ((blocked = context->blocked) < 0)
+        RtlWaitOnAddress((const void *)&context->blocked, &blocked, sizeof(blocked), NULL);
+    scheduler_oversubscribe(context, FALSE);
 }
 
 /* ?Yield@Context@Concurrency@@SAXXZ */
 /* ?_Yield@_Context@details@Concurrency@@SAXXZ */
 void __cdecl Context_Yield(void)
 {
-    FIXME("()\n");
+    TRACE("()\n");
+    SwitchToThread();
 }
 
 /* ?_SpinYield@Context@Concurrency@@SAXXZ */
 void __cdecl Context__SpinYield(void)
 {
-    FIXME("()\n");
+    TRACE("()\n");
+    Sleep(0);
 }
 
 /* ?IsCurrentTaskCollectionCanceling@Context@Concurrency@@SA_NXZ */
@@ -259,7 +321,23 @@ MSVCRT_bool __cdecl Context_IsCurrentTaskCollectionCanceling(void)
 /* ?Oversubscribe@Context@Concurrency@@SAX_N@Z */
 void __cdecl Context_Oversubscribe(MSVCRT_bool begin)
 {
-    FIXME("(%x)\n", begin);
+    ExternalContextBase *context = get_current_external_context();
+
+    TRACE("(%x)\n", begin);
+
+    if (!context)
+        return;
+
+    if (begin) {
+        context->oversubscribe++;
+    } else {
+        if (!context->oversubscribe) {
+            WARN("no matching Oversubscribe(TRUE) call\n");
+            return;
+        }
+        context->oversubscribe--;
+    }
+    scheduler_oversubscribe(context, begin);
 }
 
 /* ?ScheduleGroupId@Context@Concurrency@@SAIXZ */
@@ -302,14 +380,17 @@ unsigned int __thiscall ExternalContextBase_GetScheduleGroupId(const ExternalCon
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_Unblock, 4)
 void __thiscall ExternalContextBase_Unblock(ExternalContextBase *this)
 {
-    FIXME("(%p)->() stub\n", this);
+    TRACE("(%p)->()\n", this);
+
+    if (!InterlockedIncrement(&this->blocked))
+        RtlWakeAddressAll((const void *)&this->blocked);
 }
 
 DEFINE_THISCALL_WRAPPER(ExternalContextBase_IsSynchronouslyBlocked, 4)
 MSVCRT_bool __thiscall ExternalContextBase_IsSynchronouslyBlocked(const ExternalContextBase *this)
 {
-    FIXME("(%p)->() stub\n", this);
-    return FALSE;
+    TRACE("(%p)->()\n", this);
+    return this->blocked < 0;
 }
 
 static void ExternalContextBase_dtor(ExternalContextBase *this)
@@ -603,6 +684,15 @@ static void ThreadScheduler_dtor(ThreadScheduler *this)
     int i;
 
     if(this->ref != 0) WARN("ref = %d\n", this->ref);
+
+    /* every queued chore holds a reference, so only idle workers are left */
+    EnterCriticalSection(&chore_cs);
+    this->shutdown = TRUE;
+    WakeAllConditionVariable(&this->chores_cond);
+    while(this->worker_count)
+        SleepConditionVariableCS(&this->workers_cond, &chore_cs, INFINITE);
+    LeaveCriticalSection(&chore_cs);
+
     SchedulerPolicy_dtor(&this->policy);
 
     for(i=0; i<this->shutdown_count; i++)
@@ -717,18 +807,176 @@ DEFINE_THISCALL_WRAPPER(ThreadScheduler_CreateScheduleGroup, 4)
     return NULL;
 }
 
-DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask_loc, 16)
-void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
-        void (__cdecl *proc)(void*), void* data, /*location*/void *placement)
+/* Removes the scheduler the worker thread was created for, it's not referenced */
+static void detach_worker_context(ExternalContextBase *context)
 {
-    FIXME("(%p %p %p %p) stub\n", this, proc, data, placement);
+    struct scheduler_list *prev;
+
+    context->worker_scheduler = NULL;
+    if(!context->scheduler.next) {
+        context->scheduler.scheduler = NULL;
+        return;
+    }
+
+    for(prev = &context->scheduler; prev->next->next; prev = prev->next);
+    MSVCRT_operator_delete(prev->next);
+    prev->next = NULL;
+}
+
+static DWORD WINAPI scheduler_worker_proc(void *arg)
+{
+    ThreadScheduler *scheduler = arg;
+    struct scheduler_chore *chore;
+    ExternalContextBase *context;
+    struct list *entry;
+    HMODULE module;
+    BOOL ret;
+
+    TRACE("starting worker thread for %p\n", scheduler);
+
+    context = MSVCRT_operator_new(sizeof(*context));
+    memset(context, 0, sizeof(*context));
+    context->context.vtable = &MSVCRT_ExternalContextBase_vtable;
+    context->id = InterlockedIncrement(&context_id);
+    context->scheduler.scheduler = &scheduler->scheduler;
+    context->worker_scheduler = &scheduler->scheduler;
+    TlsSetValue(context_tls_index, context);
+
+    EnterCriticalSection(&chore_cs);
+    for(;;) {
+        if((entry = list_head(&scheduler->chores))) {
+            chore = LIST_ENTRY(entry, struct scheduler_chore, entry);
+            list_remove(entry);
+            scheduler->chore_count--;
+            LeaveCriticalSection(&chore_cs);
+
+            chore->proc(chore->data);
+            MSVCRT_operator_delete(chore);
+
+            /* release the reference taken in ScheduleTask */
+            if(!InterlockedDecrement(&scheduler->ref)) {
+                EnterCriticalSection(&chore_cs);
+                scheduler->worker_count--;
+                LeaveCriticalSection(&chore_cs);
+
+                ThreadScheduler_dtor(scheduler);
+                MSVCRT_operator_delete(scheduler);
+                scheduler = NULL;
+                break;
+            }
+
+            EnterCriticalSection(&chore_cs);
+            continue;
+        }
+
+        if(scheduler->shutdown)
+            break;
+
+        scheduler->idle_count++;
+        ret = SleepConditionVariableCS(&scheduler->chores_cond, &chore_cs, SCHEDULER_WORKER_TIMEOUT);
+        scheduler->idle_count--;
+        if(!ret && list_empty(&scheduler->chores))
+            break;
+    }
+    if(scheduler) {
+        scheduler->worker_count--;
+        WakeAllConditionVariable(&scheduler->workers_cond);
+        LeaveCriticalSection(&chore_cs);
+    }
+
+    TRACE("terminating worker thread for %p\n", arg);
+
+    detach_worker_context(context);
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+            (const WCHAR *)scheduler_worker_proc, &module);
+    FreeLibraryAndExitThread(module, 0);
+    return 0;
+}
+
+/* Must be called with chore_cs held */
+static BOOL ThreadScheduler_add_worker(ThreadScheduler *this)
+{
+    HMODULE module;
+    HANDLE thread;
+
+    /* the worker keeps the dll loaded until it exits */
+    if(!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                (const WCHAR *)scheduler_worker_proc, &module))
+        return FALSE;
+
+    thread = CreateThread(NULL, 0, scheduler_worker_proc, this, 0, NULL);
+    if(!thread) {
+        FreeLibrary(module);
+        return FALSE;
+    }
+    CloseHandle(thread);
+    this->worker_count++;
+    return TRUE;
+}
+
+static void scheduler_oversubscribe(ExternalContextBase *context, BOOL begin)
+{
+    ThreadScheduler *scheduler = (ThreadScheduler*)context->worker_scheduler;
+
+    if(!scheduler)
+        return;
+
+    EnterCriticalSection(&chore_cs);
+    if(begin) {
+        scheduler->oversubscribed++;
+        if(scheduler->chore_count > scheduler->idle_count)
+            ThreadScheduler_add_worker(scheduler);
+    } else {
+        scheduler->oversubscribed--;
+    }
+    LeaveCriticalSection(&chore_cs);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask, 12)
 void __thiscall ThreadScheduler_ScheduleTask(ThreadScheduler *this,
         void (__cdecl *proc)(void*), void* data)
 {
-    FIXME("(%p %p %p) stub\n", this, proc, data);
+    struct scheduler_chore *chore;
+    BOOL failed = FALSE;
+
+    TRACE("(%p %p %p)\n", this, proc, data);
+
+    alloc_context_tls();
+    chore = MSVCRT_operator_new(sizeof(*chore));
+    chore->proc = proc;
+    chore->data = data;
+    ThreadScheduler_Reference(this);
+
+    EnterCriticalSection(&chore_cs);
+    list_add_tail(&this->chores, &chore->entry);
+    this->chore_count++;
+    if(this->idle_count >= this->chore_count) {
+        WakeConditionVariable(&this->chores_cond);
+    } else if(this->worker_count < this->virt_proc_no + this->oversubscribed) {
+        if(!ThreadScheduler_add_worker(this) && !this->worker_count) {
+            list_remove(&chore->entry);
+            this->chore_count--;
+            failed = TRUE;
+        }
+    }
+    LeaveCriticalSection(&chore_cs);
+
+    if(failed) {
+        DWORD err = GetLastError();
+
+        MSVCRT_operator_delete(chore);
+        ThreadScheduler_Release(this);
+        throw_exception(EXCEPTION_SCHEDULER_RESOURCE_ALLOCATION_ERROR,
+                HRESULT_FROM_WIN32(err), NULL);
+    }
+}
+
+DEFINE_THISCALL_WRAPPER(ThreadScheduler_ScheduleTask_loc, 16)
+void __thiscall ThreadScheduler_ScheduleTask_loc(ThreadScheduler *this,
+        void (__cdecl *proc)(void*), void* data, /*location*/void *placement)
+{
+    TRACE("(%p %p %p %p)\n", this, proc, data, placement);
+    ThreadScheduler_ScheduleTask(this, proc, data);
 }
 
 DEFINE_THISCALL_WRAPPER(ThreadScheduler_IsAvailableLocation, 8)
@@ -779,6 +1027,14 @@ static ThreadScheduler* ThreadScheduler_ctor(ThreadScheduler *this,
     this->shutdown_count = this->shutdown_size = 0;
     this->shutdown_events = NULL;
 
+    list_init(&this->chores);
+    this->chore_count = 0;
+    InitializeConditionVariable(&this->chores_cond);
+    InitializeConditionVariable(&this->workers_cond);
+    this->worker_count = this->idle_count = 0;
+    this->oversubscribed = 0;
+    this->shutdown = FALSE;
+
     InitializeCriticalSection(&this->cs);
     this->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": ThreadScheduler");
     return this;
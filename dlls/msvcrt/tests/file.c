@@ -451,6 +451,35 @@ static void test_asciimode(void)
     ok((c = fgetc(fp)) == '1', "fgetc fails to read next char when positioned on \\r\n");
     fclose(fp);
 
+    /* Lines crossing buffer boundaries */
+    fp = fopen("ascii.tst", "w");
+    for (i = 0; i < 1000; i++)
+        fprintf(fp, "%04d %s\n", i, i % 3 ? "line" : "\r");
+    fclose(fp);
+    fp = fopen("ascii.tst", "rb");
+    for (i = 0; i < 1000; i++)
+    {
+        ok(fgets(buf, sizeof(buf), fp) != NULL, "fgets failed in line %d\n", i);
+        sprintf(buf + 32, "%04d %s\r\n", i, i % 3 ? "line" : "\r");
+        ok(!strcmp(buf, buf + 32), "line %d = %s\n", i, buf);
+    }
+    ok(fgets(buf, sizeof(buf), fp) == NULL, "fgets after EOF\n");
+    fclose(fp);
+    fp = fopen("ascii.tst", "r");
+    for (i = 0; i < 1000; i++)
+    {
+        ok(fgets(buf, 9, fp) != NULL, "fgets failed in line %d\n", i);
+        sprintf(buf + 32, "%04d %s", i, i % 3 ? "lin" : "\r\n");
+        ok(!strcmp(buf, buf + 32), "line %d = %s\n", i, buf);
+        if (i % 3)
+        {
+            ok(fgets(buf, sizeof(buf), fp) != NULL, "fgets failed in line %d\n", i);
+            ok(!strcmp(buf, "e\n"), "line %d = %s\n", i, buf);
+        }
+    }
+    ok(fgets(buf, sizeof(buf), fp) == NULL, "fgets after EOF\n");
+    fclose(fp);
+
     unlink("ascii.tst");
 }
 
@@ -21,6 +21,8 @@
 #include <stdlib.h>
 #include <malloc.h>
 #include <errno.h>
+#include <stdio.h>
+#include <string.h>
 #include "wine/test.h"
 
 static void (__cdecl *p_aligned_free)(void*) = NULL;
@@ -483,10 +485,102 @@ static void test_calloc(void)
     free(ptr);
 }
 
+static DWORD WINAPI free_thread_proc(void *arg)
+{
+    free(arg);
+    return 0;
+}
+
+static void test_small_blocks(void)
+{
+    char *mem, *mem2;
+    HANDLE thread;
+    size_t size;
+    int i;
+
+    mem = malloc(24);
+    ok(mem != NULL, "malloc failed\n");
+    size = _msize(mem);
+    ok(size == 24, "_msize returned %d\n", (int)size);
+    memset(mem, 0x55, 24);
+
+    mem = realloc(mem, 30);
+    ok(mem != NULL, "realloc failed\n");
+    size = _msize(mem);
+    ok(size == 30, "_msize returned %d\n", (int)size);
+    for (i = 0; i < 24; i++)
+        if (mem[i] != 0x55) break;
+    ok(i == 24, "data not preserved at %d\n", i);
+
+    mem2 = _expand(mem, 10);
+    ok(mem2 == mem, "_expand returned %p, expected %p\n", mem2, mem);
+    size = _msize(mem);
+    ok(size == 10, "_msize returned %d\n", (int)size);
+
+    mem2 = calloc(3, 20);
+    ok(mem2 != NULL, "calloc failed\n");
+    for (i = 0; i < 60; i++)
+        if (mem2[i]) break;
+    ok(i == 60, "memory not zeroed at %d\n", i);
+    memset(mem2, 0x66, 60);
+
+    /* growing past the small block sizes moves the data */
+    mem2 = realloc(mem2, 5000);
+    ok(mem2 != NULL, "realloc failed\n");
+    size = _msize(mem2);
+    ok(size == 5000, "_msize returned %d\n", (int)size);
+    for (i = 0; i < 60; i++)
+        if (mem2[i] != 0x66) break;
+    ok(i == 60, "data not preserved at %d\n", i);
+    free(mem2);
+
+    /* blocks may be freed by other threads */
+    thread = CreateThread(NULL, 0, free_thread_proc, mem, 0, NULL);
+    ok(thread != NULL, "CreateThread failed\n");
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+
+    for (i = 0; i < 1000; i++)
+    {
+        mem = malloc(i % 100);
+        ok(mem != NULL, "malloc failed\n");
+        free(mem);
+    }
+}
+
+static void test_small_blocks_cache(const char *selfname)
+{
+    char cmdline[MAX_PATH];
+    STARTUPINFOA startup;
+    PROCESS_INFORMATION proc;
+    BOOL ret;
+
+    /* the thread cache is only used when enabled at startup */
+    SetEnvironmentVariableA("WINE_MSVCRT_THREAD_CACHE", "1");
+    sprintf(cmdline, "\"%s\" heap small_blocks", selfname);
+    memset(&startup, 0, sizeof(startup));
+    startup.cb = sizeof(startup);
+    ret = CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &startup, &proc);
+    ok(ret, "CreateProcess failed: %u\n", GetLastError());
+    SetEnvironmentVariableA("WINE_MSVCRT_THREAD_CACHE", NULL);
+    if (!ret) return;
+
+    wait_child_process(proc.hProcess);
+    CloseHandle(proc.hProcess);
+    CloseHandle(proc.hThread);
+}
+
 START_TEST(heap)
 {
+    char **arg_v;
     void *mem;
 
+    if (winetest_get_mainargs(&arg_v) >= 3 && !strcmp(arg_v[2], "small_blocks"))
+    {
+        test_small_blocks();
+        return;
+    }
+
     mem = malloc(0);
     ok(mem != NULL, "memory not allocated for size 0\n");
     free(mem);
@@ -508,4 +602,6 @@ START_TEST(heap)
     test_aligned();
     test_sbheap();
     test_calloc();
+    test_small_blocks();
+    test_small_blocks_cache(arg_v[0]);
 }
@@ -44,6 +44,15 @@ static void (__cdecl *p_qsort_s)(void*, size_t, size_t,
 static double (__cdecl *p_atan)(double);
 static double (__cdecl *p_exp)(double);
 static double (__cdecl *p_tanh)(double);
+static double (__cdecl *p_sin)(double);
+static double (__cdecl *p_cos)(double);
+static double (__cdecl *p_log)(double);
+static double (__cdecl *p_pow)(double, double);
+static float (__cdecl *p_sinf)(float);
+static float (__cdecl *p_cosf)(float);
+static float (__cdecl *p_expf)(float);
+static float (__cdecl *p_logf)(float);
+static float (__cdecl *p_powf)(float, float);
 static void *(__cdecl *p_lfind_s)(const void*, const void*, unsigned int*,
         size_t, int (__cdecl *)(void*, const void*, const void*), void*);
 
@@ -63,6 +72,15 @@ static void init(void)
     p_atan = (void *)GetProcAddress(hmod, "atan");
     p_exp = (void *)GetProcAddress(hmod, "exp");
     p_tanh = (void *)GetProcAddress(hmod, "tanh");
+    p_sin = (void *)GetProcAddress(hmod, "sin");
+    p_cos = (void *)GetProcAddress(hmod, "cos");
+    p_log = (void *)GetProcAddress(hmod, "log");
+    p_pow = (void *)GetProcAddress(hmod, "pow");
+    p_sinf = (void *)GetProcAddress(hmod, "sinf");
+    p_cosf = (void *)GetProcAddress(hmod, "cosf");
+    p_expf = (void *)GetProcAddress(hmod, "expf");
+    p_logf = (void *)GetProcAddress(hmod, "logf");
+    p_powf = (void *)GetProcAddress(hmod, "powf");
     p_lfind_s = (void *)GetProcAddress(hmod, "_lfind_s");
 }
 
@@ -525,6 +543,107 @@ static void test_math_functions(void)
     ok(errno == 0xdeadbeef, "errno = %d\n", errno);
 }
 
+static int float_ulps(float a, float b)
+{
+    union { float f; int i; } ua, ub;
+
+    ua.f = a;
+    ub.f = b;
+    if (ua.i < 0) ua.i = 0x80000000 - ua.i;
+    if (ub.i < 0) ub.i = 0x80000000 - ub.i;
+    return abs(ua.i - ub.i);
+}
+
+static void test_float_math_functions(void)
+{
+    float x, y, ret;
+    int i, ulps;
+
+    if (!p_sinf)
+    {
+        win_skip("float math functions not available\n");
+        return;
+    }
+
+    for (i = -4000; i <= 4000; i++)
+    {
+        x = i * 0.0123f;
+
+        ret = p_sinf(x);
+        ulps = float_ulps(ret, p_sin(x));
+        ok(ulps <= 1, "sinf(%.9g) = %.9g, %d ulps off\n", x, ret, ulps);
+
+        ret = p_cosf(x);
+        ulps = float_ulps(ret, p_cos(x));
+        ok(ulps <= 1, "cosf(%.9g) = %.9g, %d ulps off\n", x, ret, ulps);
+
+        x = i * 0.02197f;
+        ret = p_expf(x);
+        ulps = float_ulps(ret, p_exp(x));
+        ok(ulps <= 1, "expf(%.9g) = %.9g, %d ulps off\n", x, ret, ulps);
+
+        x = (i + 4001) * 0.0137f;
+        ret = p_logf(x);
+        ulps = float_ulps(ret, p_log(x));
+        ok(ulps <= 1, "logf(%.9g) = %.9g, %d ulps off\n", x, ret, ulps);
+
+        y = i * 0.00731f;
+        ret = p_powf(x, y);
+        ulps = float_ulps(ret, p_pow(x, y));
+        ok(ulps <= 1, "powf(%.9g, %.9g) = %.9g, %d ulps off\n", x, y, ret, ulps);
+    }
+
+    /* tiny and huge arguments */
+    ret = p_sinf(1e-30f);
+    ok(ret == 1e-30f, "sinf(1e-30) = %.9g\n", ret);
+    ret = p_cosf(1e-30f);
+    ok(ret == 1.0f, "cosf(1e-30) = %.9g\n", ret);
+    ret = p_sinf(1e6f);
+    ulps = float_ulps(ret, p_sin(1e6));
+    ok(ulps <= 1, "sinf(1e6) = %.9g, %d ulps off\n", ret, ulps);
+    ret = p_logf(1e-40f);
+    ulps = float_ulps(ret, p_log(1e-40f));
+    ok(ulps <= 1, "logf(1e-40) = %.9g, %d ulps off\n", ret, ulps);
+    ret = p_powf(1.0f, 1e30f);
+    ok(ret == 1.0f, "powf(1, 1e30) = %.9g\n", ret);
+
+    errno = 0xdeadbeef;
+    ret = p_expf(100.0f);
+    ok(ret == INFINITY, "expf(100) = %.9g\n", ret);
+    ok(errno == ERANGE, "errno = %d\n", errno);
+
+    errno = 0xdeadbeef;
+    ret = p_expf(-50.0f);
+    ok(errno == 0xdeadbeef, "errno = %d\n", errno);
+
+    errno = 0xdeadbeef;
+    ret = p_logf(0.0f);
+    ok(ret == -INFINITY, "logf(0) = %.9g\n", ret);
+    ok(errno == ERANGE, "errno = %d\n", errno);
+
+    errno = 0xdeadbeef;
+    p_logf(-1.0f);
+    ok(errno == EDOM, "errno = %d\n", errno);
+
+    errno = 0xdeadbeef;
+    ret = p_powf(2.0f, 0.5f);
+    ok(ret == 1.41421354f, "powf(2, 0.5) = %.9g\n", ret);
+    ok(errno == 0xdeadbeef, "errno = %d\n", errno);
+
+    errno = 0xdeadbeef;
+    p_powf(-2.0f, 0.5f);
+    ok(errno == EDOM, "errno = %d\n", errno);
+
+    errno = 0xdeadbeef;
+    ret = p_powf(10.0f, 50.0f);
+    ok(ret == INFINITY, "powf(10, 50) = %.9g\n", ret);
+    ok(errno == ERANGE, "errno = %d\n", errno);
+
+    errno = 0xdeadbeef;
+    p_sinf(INFINITY);
+    ok(errno == EDOM, "errno = %d\n", errno);
+}
+
 static void __cdecl test_thread_func(void *end_thread_type)
 {
     if (end_thread_type == (void*)1)
@@ -681,6 +800,7 @@ START_TEST(misc)
     test__invalid_parameter();
     test_qsort_s();
     test_math_functions();
+    test_float_math_functions();
     test_thread_handle_close();
     test__lfind_s();
 }
@@ -196,6 +196,10 @@ static void test_sprintf( void )
         { "%Ls", "not wide", 0, PTR_ARG, 0, 0, 0, "not wide" },
         { "%b", "b", 0, NO_ARG },
         { "%3c", "  a", 0, INT_ARG, 'a' },
+        { "%40d", "                                       1", 0, INT_ARG, 1 },
+        { "%-40x", "abc                                     ", 0, INT_ARG, 0xabc },
+        { "%040d", "-000000000000000000000000000000000000001", 0, INT_ARG, -1 },
+        { "%+70u", "                                                            4294967295", 0, INT_ARG, -1 },
         { "%3d", "1234", 0, INT_ARG, 1234 },
         { "%3h", "", 0, NO_ARG },
         { "%k%m%q%r%t%v%y%z", "kmqrtvyz", 0, NO_ARG },
@@ -203,6 +207,12 @@ static void test_sprintf( void )
         { "%2.4f", "8.6000", 0, DOUBLE_ARG, 0, 0, 8.6 },
         { "%0f", "0.600000", 0, DOUBLE_ARG, 0, 0, 0.6 },
         { "%.0f", "1", 0, DOUBLE_ARG, 0, 0, 0.6 },
+        { "%f", "1234567.125000", 0, DOUBLE_ARG, 0, 0, 1234567.125 },
+        { "%.1f", "0.1", 0, DOUBLE_ARG, 0, 0, 0.05 },
+        { "%#.0f", "3.", 0, DOUBLE_ARG, 0, 0, 3.0 },
+        { "%08.3f", "-001.500", 0, DOUBLE_ARG, 0, 0, -1.5 },
+        { "%.3f", "0.000", 0, DOUBLE_ARG, 0, 0, 1e-300 },
+        { "%.2f", "100000000000000000000.00", 0, DOUBLE_ARG, 0, 0, 1e20 },
         { "%2.4e", "8.6000e+000", 0, DOUBLE_ARG, 0, 0, 8.6 },
         { "% 2.4e", " 8.6000e+000", 0, DOUBLE_ARG, 0, 0, 8.6 },
         { "% 014.4e", " 008.6000e+000", 0, DOUBLE_ARG, 0, 0, 8.6 },
@@ -255,7 +265,7 @@ static void test_sprintf( void )
         { "%.30lf", "1.414213562373095100000000000000", 0, TODO_FLAG | DOUBLE_ARG, 0, 0, sqrt(2) },
     };
 
-    char buffer[100];
+    char buffer[100], format[16];
     int i, x, r;
 
     for (i=0; i<ARRAY_SIZE(tests); i++) {
@@ -395,6 +405,16 @@ static void test_sprintf( void )
     ok(r==14, "r = %d\n", r);
     ok(!strcmp(buffer, "string to copy"), "failed: \"%s\"\n", buffer);
 
+    /* the same format buffer with different contents */
+    strcpy(format, "%d:%s");
+    r = p_sprintf(buffer, format, 12, "ab");
+    ok(r==5, "r = %d\n", r);
+    ok(!strcmp(buffer, "12:ab"), "failed: \"%s\"\n", buffer);
+    strcpy(format, "%x-%c");
+    r = p_sprintf(buffer, format, 255, 'z');
+    ok(r==4, "r = %d\n", r);
+    ok(!strcmp(buffer, "ff-z"), "failed: \"%s\"\n", buffer);
+
     setlocale(LC_ALL, "C");
 }
 
@@ -434,6 +454,7 @@ static void test_snprintf (void)
     char buffer[8];
     const int bufsiz = sizeof buffer;
     unsigned int i;
+    int n;
 
     for (i = 0; i < ARRAY_SIZE(tests); i++) {
         const char *fmt  = tests[i].format;
@@ -446,6 +467,11 @@ static void test_snprintf (void)
         ok (!memcmp (fmt, buffer, valid),
             "\"%s\": rendered \"%.*s\"\n", fmt, valid, buffer);
     }
+
+    /* the output can be truncated in the middle of the padding */
+    n = _snprintf (buffer, bufsiz, "%20d", 1);
+    ok (n == -1, "expected -1, returned %d\n", n);
+    ok (!memcmp (buffer, "        ", bufsiz), "rendered \"%.*s\"\n", bufsiz, buffer);
 }
 
 static void test_fprintf(void)
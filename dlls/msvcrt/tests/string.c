@@ -634,8 +634,47 @@ static void test_strdup(void)
    free( str );
 }
 
+static void test_wcs_alignment(void)
+{
+    static const wchar_t str[] = {'a','b','c','d','e','f','g','h','i','j','k','l','m','n','o','p',0x100,0x2000,0x8000,0};
+    wchar_t buf1[32], buf2[32];
+    int i, j, len;
+    wchar_t *p;
+
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(str) - 1; j++)
+        {
+            memcpy( buf1 + i, str, sizeof(str) );
+            memcpy( buf2 + (i + j) % 4, str, sizeof(str) );
+
+            len = wcslen( buf1 + i );
+            ok( len == ARRAY_SIZE(str) - 1, "%d %d: wrong length %d\n", i, j, len );
+            p = wcschr( buf1 + i, str[j] );
+            ok( p == buf1 + i + j, "%d %d: got %p, expected %p\n", i, j, p, buf1 + i + j );
+            p = wcschr( buf1 + i, 0 );
+            ok( p == buf1 + i + ARRAY_SIZE(str) - 1, "%d %d: got %p\n", i, j, p );
+            p = wcschr( buf1 + i, 'z' );
+            ok( !p, "%d %d: got %p\n", i, j, p );
+            ok( !wcscmp( buf1 + i, buf2 + (i + j) % 4 ), "%d %d: strings differ\n", i, j );
+
+            buf2[(i + j) % 4 + j] = 0xfffe;
+            ok( wcscmp( buf1 + i, buf2 + (i + j) % 4 ) < 0, "%d %d: wrong order\n", i, j );
+            ok( wcscmp( buf2 + (i + j) % 4, buf1 + i ) > 0, "%d %d: wrong order\n", i, j );
+
+            buf2[(i + j) % 4 + j] = 0;
+            len = wcslen( buf2 + (i + j) % 4 );
+            ok( len == j, "%d %d: wrong length %d\n", i, j, len );
+            ok( wcscmp( buf1 + i, buf2 + (i + j) % 4 ) > 0, "%d %d: wrong order\n", i, j );
+        }
+    }
+}
+
 static void test_strcmp(void)
 {
+    static const char str[] = "abcdefghijklmnopqrstuvwxyz";
+    char buf1[64], buf2[64];
+    int i, j;
     int ret = p_strcmp( "abc", "abcd" );
     ok( ret == -1, "wrong ret %d\n", ret );
     ret = p_strcmp( "", "abc" );
@@ -647,6 +686,28 @@ static void test_strcmp(void)
     ret = p_strcmp( "ab\xc2", "ab\xc2" );
     ok( ret == 0, "wrong ret %d\n", ret );
 
+    /* differences at every position and alignment */
+    for (i = 0; i < 8; i++)
+    {
+        for (j = 0; j < sizeof(str) - 1; j++)
+        {
+            memcpy( buf1 + i, str, sizeof(str) );
+            memcpy( buf2 + (i + j) % 8, str, sizeof(str) );
+            ret = p_strcmp( buf1 + i, buf2 + (i + j) % 8 );
+            ok( ret == 0, "%d %d: wrong ret %d\n", i, j, ret );
+
+            buf2[(i + j) % 8 + j] = '\xe0';
+            ret = p_strcmp( buf1 + i, buf2 + (i + j) % 8 );
+            ok( ret == -1, "%d %d: wrong ret %d\n", i, j, ret );
+            ret = p_strcmp( buf2 + (i + j) % 8, buf1 + i );
+            ok( ret == 1, "%d %d: wrong ret %d\n", i, j, ret );
+
+            buf2[(i + j) % 8 + j] = 0;
+            ret = p_strcmp( buf1 + i, buf2 + (i + j) % 8 );
+            ok( ret == 1, "%d %d: wrong ret %d\n", i, j, ret );
+        }
+    }
+
     ret = p_strncmp( "abc", "abcd", 3 );
     ok( ret == 0, "wrong ret %d\n", ret );
     ret = p_strncmp( "", "abc", 3 );
@@ -1961,6 +2022,14 @@ static void test__strtod(void)
         { ".00", 3, 0 },
         { "-0.", 3, 0 },
         { "0e13", 4, 0 },
+        { "9007199254740993", 16, 9007199254740992.0 },
+        { "9007199254740995", 16, 9007199254740996.0 },
+        { "1e23", 4, 1e23 },
+        { "-8.98846567431158e307", 21, -8.98846567431158e307 },
+        { "2.2250738585072014e-308", 23, 2.2250738585072014e-308 },
+        { "4.9406564584124654e-324", 23, 4.9406564584124654e-324 },
+        { "0.000123456789012345678", 23, 0.000123456789012345678 },
+        { "1234567890123456789012e-10", 26, 1234567890123456789012e-10 },
     };
     const char overflow[] = "1d9999999999999999999";
 
@@ -4359,4 +4428,5 @@ START_TEST(string)
     test_C_locale();
     test_strstr();
     test_iswdigit();
+    test_wcs_alignment();
 }
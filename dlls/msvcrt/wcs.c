@@ -2532,6 +2532,22 @@ int CDECL MSVCRT_towlower(MSVCRT_wint_t c)
  */
 MSVCRT_wchar_t* CDECL MSVCRT_wcschr(const MSVCRT_wchar_t *str, MSVCRT_wchar_t ch)
 {
+    if (!((MSVCRT_size_t)str & 1))
+    {
+        MSVCRT_size_t pattern = WORD_WCHAR_LOW_BITS * ch;
+        const MSVCRT_size_t *word;
+
+        while (!is_word_aligned(str))
+        {
+            if (*str == ch) return (MSVCRT_wchar_t *)str;
+            if (!*str++) return NULL;
+        }
+
+        word = (const MSVCRT_size_t *)str;
+        while (!word_has_zero_wchar(*word) && !word_has_zero_wchar(*word ^ pattern)) word++;
+        str = (const MSVCRT_wchar_t *)word;
+    }
+
     return strchrW(str, ch);
 }
 
@@ -2548,7 +2564,22 @@ MSVCRT_wchar_t* CDECL MSVCRT_wcsrchr(const MSVCRT_wchar_t *str, MSVCRT_wchar_t c
  */
 int CDECL MSVCRT_wcslen(const MSVCRT_wchar_t *str)
 {
-    return strlenW(str);
+    const MSVCRT_wchar_t *s = str;
+
+    if (!((MSVCRT_size_t)s & 1))
+    {
+        const MSVCRT_size_t *word;
+
+        while (!is_word_aligned(s))
+            if (!*s++) return s - str - 1;
+
+        word = (const MSVCRT_size_t *)s;
+        while (!word_has_zero_wchar(*word)) word++;
+        s = (const MSVCRT_wchar_t *)word;
+    }
+
+    while (*s) s++;
+    return s - str;
 }
 
 /*********************************************************************
@@ -2665,5 +2696,20 @@ MSVCRT_size_t CDECL MSVCRT_wcsxfrm(MSVCRT_wchar_t *dest,
  */
 int CDECL MSVCRT_wcscmp(const MSVCRT_wchar_t *str1, const MSVCRT_wchar_t *str2)
 {
+    if (!(((MSVCRT_size_t)str1 ^ (MSVCRT_size_t)str2) & (WORD_SIZE - 1)) && !((MSVCRT_size_t)str1 & 1))
+    {
+        while (!is_word_aligned(str1) && *str1 && *str1 == *str2) { str1++; str2++; }
+
+        if (is_word_aligned(str1))
+        {
+            const MSVCRT_size_t *word1 = (const MSVCRT_size_t *)str1;
+            const MSVCRT_size_t *word2 = (const MSVCRT_size_t *)str2;
+
+            while (*word1 == *word2 && !word_has_zero_wchar(*word1)) { word1++; word2++; }
+            str1 = (const MSVCRT_wchar_t *)word1;
+            str2 = (const MSVCRT_wchar_t *)word2;
+        }
+    }
+
     return strcmpW(str1, str2);
 }
@@ -209,6 +209,8 @@ typedef struct _xmldoc_priv {
     LONG refs;
     struct list orphans;
     domdoc_properties* properties;
+    struct list xpath_cache;
+    unsigned int xpath_cache_size;
 } xmldoc_priv;
 
 typedef struct _orphan_entry {
@@ -216,6 +218,27 @@ typedef struct _orphan_entry {
     xmlNode * node;
 } orphan_entry;
 
+/* Compiled selectNodes()/selectSingleNode() expressions, most recently used first.
+   XSLPattern translation depends on the selection namespaces, so they are part of the key. */
+#define XPATH_CACHE_SIZE 16
+
+typedef struct _xpath_cache_entry {
+    struct list entry;
+    BOOL xpath;
+    xmlChar *query;
+    xmlChar *ns;
+    xmlXPathCompExprPtr comp;
+} xpath_cache_entry;
+
+static CRITICAL_SECTION xpath_cache_cs;
+static CRITICAL_SECTION_DEBUG xpath_cache_cs_dbg =
+{
+    0, 0, &xpath_cache_cs,
+    { &xpath_cache_cs_dbg.ProcessLocksList, &xpath_cache_cs_dbg.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": xpath_cache") }
+};
+static CRITICAL_SECTION xpath_cache_cs = { &xpath_cache_cs_dbg, -1, 0, 0, 0, 0 };
+
 typedef struct _select_ns_entry {
     struct list entry;
     xmlChar const* prefix;
@@ -281,6 +304,8 @@ static xmldoc_priv * create_priv(void)
         priv->refs = 0;
         list_init( &priv->orphans );
         priv->properties = NULL;
+        list_init( &priv->xpath_cache );
+        priv->xpath_cache_size = 0;
     }
 
     return priv;
@@ -372,7 +397,11 @@ static void release_namespaces(domdoc *This)
 void xmldoc_link_xmldecl(xmlDocPtr doc, xmlNodePtr node)
 {
     assert(doc != NULL);
-    if (doc->standalone != -1) xmlAddPrevSibling( doc->children, node );
+    if (doc->standalone != -1)
+    {
+        xmlAddPrevSibling( doc->children, node );
+        node_tree_modified();
+    }
 }
 
 /* unlinks a first "<?xml" child if it was created */
@@ -390,6 +419,7 @@ xmlNodePtr xmldoc_unlink_xmldecl(xmlDocPtr doc)
     {
         node = first_child;
         xmlUnlinkNode( node );
+        node_tree_modified();
     }
     else
         node = NULL;
@@ -591,6 +621,87 @@ void xmldoc_init(xmlDocPtr doc, MSXML_VERSION version)
     priv_from_xmlDocPtr(doc)->properties = create_properties(version);
 }
 
+static void free_xpath_cache_entry(xpath_cache_entry *entry)
+{
+    xmlXPathFreeCompExpr(entry->comp);
+    heap_free(entry->query);
+    heap_free(entry->ns);
+    heap_free(entry);
+}
+
+static void clear_xpath_cache(xmldoc_priv *priv)
+{
+    xpath_cache_entry *entry, *entry2;
+
+    LIST_FOR_EACH_ENTRY_SAFE( entry, entry2, &priv->xpath_cache, xpath_cache_entry, entry )
+        free_xpath_cache_entry(entry);
+    list_init(&priv->xpath_cache);
+    priv->xpath_cache_size = 0;
+}
+
+/* Takes a compiled expression out of the document cache, the caller owns it until
+   it's handed back with xmldoc_put_xpath_expr(). */
+xmlXPathCompExprPtr xmldoc_get_xpath_expr(xmlDocPtr doc, const xmlChar *query, BOOL xpath)
+{
+    xmldoc_priv *priv = priv_from_xmlDocPtr(doc);
+    const xmlChar *ns = properties_from_xmlDocPtr(doc)->selectNsStr;
+    xmlXPathCompExprPtr comp = NULL;
+    xpath_cache_entry *entry;
+
+    EnterCriticalSection(&xpath_cache_cs);
+    LIST_FOR_EACH_ENTRY( entry, &priv->xpath_cache, xpath_cache_entry, entry )
+    {
+        if (entry->xpath == xpath && xmlStrEqual(entry->query, query) && xmlStrEqual(entry->ns, ns))
+        {
+            comp = entry->comp;
+            entry->comp = NULL;
+            list_remove(&entry->entry);
+            priv->xpath_cache_size--;
+            break;
+        }
+    }
+    LeaveCriticalSection(&xpath_cache_cs);
+
+    if (!comp) return NULL;
+
+    TRACE("(%p)->(%s) cache hit\n", doc, debugstr_a((char const*)query));
+    heap_free(entry->query);
+    heap_free(entry->ns);
+    heap_free(entry);
+    return comp;
+}
+
+void xmldoc_put_xpath_expr(xmlDocPtr doc, const xmlChar *query, BOOL xpath, xmlXPathCompExprPtr comp)
+{
+    xmldoc_priv *priv = priv_from_xmlDocPtr(doc);
+    const xmlChar *ns = properties_from_xmlDocPtr(doc)->selectNsStr;
+    xpath_cache_entry *entry, *evicted = NULL;
+
+    if (!(entry = heap_alloc(sizeof(*entry))) ||
+        !(entry->query = heap_strdupxmlChar(query)) ||
+        !(entry->ns = heap_strdupxmlChar(ns)))
+    {
+        if (entry) heap_free(entry->query);
+        heap_free(entry);
+        xmlXPathFreeCompExpr(comp);
+        return;
+    }
+    entry->xpath = xpath;
+    entry->comp = comp;
+
+    EnterCriticalSection(&xpath_cache_cs);
+    list_add_head(&priv->xpath_cache, &entry->entry);
+    if (++priv->xpath_cache_size > XPATH_CACHE_SIZE)
+    {
+        evicted = LIST_ENTRY(list_tail(&priv->xpath_cache), xpath_cache_entry, entry);
+        list_remove(&evicted->entry);
+        priv->xpath_cache_size--;
+    }
+    LeaveCriticalSection(&xpath_cache_cs);
+
+    if (evicted) free_xpath_cache_entry(evicted);
+}
+
 LONG xmldoc_add_refs(xmlDocPtr doc, LONG refs)
 {
     LONG ref = InterlockedExchangeAdd(&priv_from_xmlDocPtr(doc)->refs, refs) + refs;
@@ -622,6 +733,7 @@ LONG xmldoc_release_refs(xmlDocPtr doc, LONG refs)
             xmlFreeNode( orphan->node );
             heap_free( orphan );
         }
+        clear_xpath_cache(priv);
         free_properties(priv->properties);
         heap_free(doc->_private);
 
@@ -1661,6 +1773,7 @@ static HRESULT WINAPI domdoc_put_documentElement(
     /* old root is still orphaned by its document, update refcount from new root */
     if (refcount) xmldoc_add_refs(get_doc(This), refcount);
     oldRoot = xmlDocSetRootElement( get_doc(This), xmlNode->node);
+    node_tree_modified();
     if (refcount) xmldoc_release_refs(old_doc, refcount);
     IXMLDOMNode_Release( elementNode );
 
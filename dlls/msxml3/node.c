@@ -59,6 +59,8 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(msxml);
 
+LONG node_tree_version;
+
 #ifdef SONAME_LIBXSLT
 extern void* libxslt_handle;
 # define MAKE_FUNCPTR(f) extern typeof(f) * p##f
@@ -264,6 +266,7 @@ HRESULT node_set_content(xmlnode *This, LPCWSTR value)
         return E_OUTOFMEMORY;
 
     xmlNodeSetContent(This->node, str);
+    node_tree_modified();
     heap_free(str);
     return S_OK;
 }
@@ -285,6 +288,7 @@ static HRESULT node_set_content_escaped(xmlnode *This, LPCWSTR value)
     }
 
     xmlNodeSetContent(This->node, escaped);
+    node_tree_modified();
 
     heap_free(str);
     xmlFree(escaped);
@@ -545,6 +549,7 @@ HRESULT node_insert_before(xmlnode *This, IXMLDOMNode *new_child, const VARIANT
         if (refcount) xmldoc_release_refs(doc, refcount);
         node_obj->parent = This->iface;
     }
+    node_tree_modified();
 
     if(ret)
     {
@@ -606,6 +611,7 @@ HRESULT node_replace_child(xmlnode *This, IXMLDOMNode *newChild, IXMLDOMNode *ol
 
     if (refcount) xmldoc_add_refs(old_child->node->doc, refcount);
     xmlReplaceNode(old_child->node, new_child->node);
+    node_tree_modified();
     if (refcount) xmldoc_release_refs(leaving_doc, refcount);
     new_child->parent = old_child->parent;
     old_child->parent = NULL;
@@ -640,6 +646,7 @@ HRESULT node_remove_child(xmlnode *This, IXMLDOMNode* child, IXMLDOMNode** oldCh
     }
 
     xmlUnlinkNode(child_node->node);
+    node_tree_modified();
     child_node->parent = NULL;
     xmldoc_add_orphan(child_node->node->doc, child_node->node);
 
@@ -893,6 +900,7 @@ HRESULT node_put_text(xmlnode *This, BSTR text)
     heap_free(str);
 
     xmlNodeSetContent(This->node, str2);
+    node_tree_modified();
     xmlFree(str2);
 
     return S_OK;
@@ -2255,6 +2263,7 @@ static const struct IXMLDOMNodeVtbl unknode_vtbl =
     unknode_transformNodeToObject
 };
 
+/* All node objects but documents are created with their IXMLDOMNode derived interface. */
 IXMLDOMNode *create_node( xmlNodePtr node )
 {
     IUnknown *pUnk;
@@ -2290,7 +2299,11 @@ IXMLDOMNode *create_node( xmlNodePtr node )
         break;
     case XML_DOCUMENT_NODE:
         pUnk = create_domdoc( node );
-        break;
+        if (!pUnk) return NULL;
+        hr = IUnknown_QueryInterface(pUnk, &IID_IXMLDOMNode, (LPVOID*)&ret);
+        IUnknown_Release(pUnk);
+        if(FAILED(hr)) return NULL;
+        return ret;
     case XML_DOCUMENT_FRAG_NODE:
         pUnk = create_doc_fragment( node );
         break;
@@ -2319,9 +2332,6 @@ IXMLDOMNode *create_node( xmlNodePtr node )
         return NULL;
     }
 
-    hr = IUnknown_QueryInterface(pUnk, &IID_IXMLDOMNode, (LPVOID*)&ret);
-    IUnknown_Release(pUnk);
-    if(FAILED(hr)) return NULL;
-    return ret;
+    return (IXMLDOMNode*)pUnk;
 }
 #endif
@@ -60,6 +60,11 @@ typedef struct
     xmlNodePtr parent;
     xmlNodePtr current;
     IEnumVARIANT *enumvariant;
+    /* last position found by item() and the list length, valid for tree_version only */
+    LONG tree_version;
+    LONG cached_index;
+    xmlNodePtr cached_node;
+    LONG length;
 } xmlnodelist;
 
 static HRESULT nodelist_get_item(IUnknown *iface, LONG index, VARIANT *item)
@@ -193,6 +198,64 @@ static HRESULT WINAPI xmlnodelist_Invoke(
         dispIdMember, riid, lcid, wFlags, pDispParams, pVarResult, pExcepInfo, puArgErr);
 }
 
+static void nodelist_validate_cache(xmlnodelist *This)
+{
+    if (This->tree_version == node_tree_version)
+        return;
+
+    This->tree_version = node_tree_version;
+    This->cached_node = NULL;
+    This->length = -1;
+}
+
+static inline LONG index_distance(LONG a, LONG b)
+{
+    return a > b ? a - b : b - a;
+}
+
+/* Walks from the closest of the first child, the last child and the previously found child. */
+static xmlNodePtr nodelist_find_item(xmlnodelist *This, LONG index)
+{
+    xmlNodePtr curr = This->parent->children;
+    LONG curr_index = 0;
+
+    nodelist_validate_cache(This);
+
+    if (This->length != -1)
+    {
+        if (index >= This->length)
+            return NULL;
+        if (This->length - 1 - index < index)
+        {
+            curr = This->parent->last;
+            curr_index = This->length - 1;
+        }
+    }
+    if (This->cached_node && index_distance(index, This->cached_index) < index_distance(index, curr_index))
+    {
+        curr = This->cached_node;
+        curr_index = This->cached_index;
+    }
+
+    while (curr && curr_index < index)
+    {
+        curr = curr->next;
+        curr_index++;
+    }
+    while (curr && curr_index > index)
+    {
+        curr = curr->prev;
+        curr_index--;
+    }
+
+    if (curr)
+    {
+        This->cached_node = curr;
+        This->cached_index = index;
+    }
+    return curr;
+}
+
 static HRESULT WINAPI xmlnodelist_get_item(
         IXMLDOMNodeList* iface,
         LONG index,
@@ -200,7 +263,6 @@ static HRESULT WINAPI xmlnodelist_get_item(
 {
     xmlnodelist *This = impl_from_IXMLDOMNodeList( iface );
     xmlNodePtr curr;
-    LONG nodeIndex = 0;
 
     TRACE("(%p)->(%d %p)\n", This, index, listItem);
 
@@ -212,12 +274,7 @@ static HRESULT WINAPI xmlnodelist_get_item(
     if (index < 0)
         return S_FALSE;
 
-    curr = This->parent->children;
-    while(curr)
-    {
-        if(nodeIndex++ == index) break;
-        curr = curr->next;
-    }
+    curr = nodelist_find_item(This, index);
     if(!curr) return S_FALSE;
 
     *listItem = create_node( curr );
@@ -240,6 +297,13 @@ static HRESULT WINAPI xmlnodelist_get_length(
     if(!listLength)
         return E_INVALIDARG;
 
+    nodelist_validate_cache(This);
+    if (This->length != -1)
+    {
+        *listLength = This->length;
+        return S_OK;
+    }
+
     curr = This->parent->children;
     while (curr)
     {
@@ -247,7 +311,7 @@ static HRESULT WINAPI xmlnodelist_get_length(
         curr = curr->next;
     }
 
-    *listLength = nodeCount;
+    *listLength = This->length = nodeCount;
     return S_OK;
 }
 
@@ -420,6 +484,9 @@ IXMLDOMNodeList* create_children_nodelist( xmlNodePtr node )
     This->parent = node;
     This->current = node->children;
     This->enumvariant = NULL;
+    This->tree_version = node_tree_version;
+    This->cached_node = NULL;
+    This->length = -1;
     xmldoc_add_ref( node->doc );
 
     init_dispex(&This->dispex, (IUnknown*)&This->IXMLDOMNodeList_iface, &xmlnodelist_dispex);
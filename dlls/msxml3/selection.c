@@ -58,6 +58,8 @@ WINE_DEFAULT_DEBUG_CHANNEL(msxml);
 
 int registerNamespaces(xmlXPathContextPtr ctxt);
 xmlChar* XSLPattern_to_XPath(xmlXPathContextPtr ctxt, xmlChar const* xslpat_str);
+xmlXPathCompExprPtr xmldoc_get_xpath_expr(xmlDocPtr doc, const xmlChar *query, BOOL xpath);
+void xmldoc_put_xpath_expr(xmlDocPtr doc, const xmlChar *query, BOOL xpath, xmlXPathCompExprPtr comp);
 
 typedef struct
 {
@@ -769,6 +771,8 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
 {
     domselection *This = heap_alloc(sizeof(domselection));
     xmlXPathContextPtr ctxt = xmlXPathNewContext(node->doc);
+    xmlXPathCompExprPtr comp;
+    BOOL xpath;
     HRESULT hr;
 
     TRACE("(%p, %s, %p)\n", node, debugstr_a((char const*)query), out);
@@ -793,15 +797,16 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
     ctxt->node = node;
     registerNamespaces(ctxt);
 
-    if (is_xpathmode(This->node->doc))
+    xpath = is_xpathmode(This->node->doc);
+    comp = xmldoc_get_xpath_expr(node->doc, query, xpath);
+
+    if (xpath)
     {
         xmlXPathRegisterAllFunctions(ctxt);
-        This->result = xmlXPathEvalExpression(query, ctxt);
+        if (!comp) comp = xmlXPathCtxtCompile(ctxt, query);
     }
     else
     {
-        xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
-
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"not", xmlXPathNotFunction);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"boolean", xmlXPathBooleanFunction);
 
@@ -816,9 +821,21 @@ HRESULT create_selection(xmlNodePtr node, xmlChar* query, IXMLDOMNodeList **out)
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGt", XSLPattern_OP_IGt);
         xmlXPathRegisterFunc(ctxt, (xmlChar const*)"OP_IGEq", XSLPattern_OP_IGEq);
 
-        This->result = xmlXPathEvalExpression(pattern_query, ctxt);
-        xmlFree(pattern_query);
+        if (!comp)
+        {
+            xmlChar* pattern_query = XSLPattern_to_XPath(ctxt, query);
+            comp = xmlXPathCtxtCompile(ctxt, pattern_query);
+            xmlFree(pattern_query);
+        }
+    }
+
+    if (comp)
+    {
+        This->result = xmlXPathCompiledEval(comp, ctxt);
+        xmldoc_put_xpath_expr(node->doc, query, xpath, comp);
     }
+    else
+        This->result = NULL;
 
     if (!This->result || This->result->type != XPATH_NODESET)
     {
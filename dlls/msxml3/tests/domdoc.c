@@ -3738,6 +3738,203 @@ static void test_get_childNodes(void)
     free_bstrs();
 }
 
+#define expect_list_item(list, index, name) _expect_list_item(__LINE__, list, index, name)
+static void _expect_list_item(unsigned line, IXMLDOMNodeList *list, LONG index, const char *name)
+{
+    IXMLDOMNode *node;
+    HRESULT hr;
+    BSTR str;
+
+    hr = IXMLDOMNodeList_get_item(list, index, &node);
+    ok_(__FILE__,line)(hr == (name ? S_OK : S_FALSE), "get_item(%d) returned %#x\n", index, hr);
+    if (hr != S_OK)
+    {
+        ok_(__FILE__,line)(!node, "got %p\n", node);
+        return;
+    }
+
+    hr = IXMLDOMNode_get_nodeName(node, &str);
+    ok_(__FILE__,line)(hr == S_OK, "get_nodeName returned %#x\n", hr);
+    ok_(__FILE__,line)(!lstrcmpW(str, _bstr_(name)), "item %d is %s, expected %s\n", index,
+                       wine_dbgstr_w(str), name);
+    SysFreeString(str);
+    IXMLDOMNode_Release(node);
+}
+
+static void test_childNodes_index(void)
+{
+    IXMLDOMNodeList *node_list;
+    IXMLDOMDocument *doc;
+    IXMLDOMElement *element;
+    IXMLDOMNode *node, *node2;
+    VARIANT_BOOL b;
+    char buf[4096], name[16];
+    HRESULT hr;
+    VARIANT v;
+    LONG len;
+    int i;
+
+    strcpy(buf, "<a>");
+    for (i = 0; i < 100; i++)
+        sprintf(buf + strlen(buf), "<b%d/>", i);
+    strcat(buf, "</a>");
+
+    doc = create_document(&IID_IXMLDOMDocument);
+
+    hr = IXMLDOMDocument_loadXML(doc, _bstr_(buf), &b);
+    ok(hr == S_OK, "loadXML failed: %#x\n", hr);
+    ok(b == VARIANT_TRUE, "failed to load XML string\n");
+
+    hr = IXMLDOMDocument_get_documentElement(doc, &element);
+    ok(hr == S_OK, "get_documentElement failed: %#x\n", hr);
+
+    hr = IXMLDOMElement_get_childNodes(element, &node_list);
+    ok(hr == S_OK, "get_childNodes failed: %#x\n", hr);
+
+    hr = IXMLDOMNodeList_get_length(node_list, &len);
+    ok(hr == S_OK, "get_length failed: %#x\n", hr);
+    ok(len == 100, "len %d\n", len);
+
+    /* forward, backward and random access */
+    for (i = 0; i < 100; i++)
+    {
+        sprintf(name, "b%d", i);
+        expect_list_item(node_list, i, name);
+    }
+    for (i = 99; i >= 0; i -= 7)
+    {
+        sprintf(name, "b%d", i);
+        expect_list_item(node_list, i, name);
+    }
+    expect_list_item(node_list, 50, "b50");
+    expect_list_item(node_list, 3, "b3");
+    expect_list_item(node_list, 97, "b97");
+    expect_list_item(node_list, 100, NULL);
+    expect_list_item(node_list, 1000, NULL);
+    expect_list_item(node_list, -1, NULL);
+    free_bstrs();
+
+    /* the list is live, changes invalidate the cached position and length */
+    hr = IXMLDOMNodeList_get_item(node_list, 50, &node);
+    ok(hr == S_OK, "get_item failed: %#x\n", hr);
+    hr = IXMLDOMElement_removeChild(element, node, NULL);
+    ok(hr == S_OK, "removeChild failed: %#x\n", hr);
+
+    hr = IXMLDOMNodeList_get_length(node_list, &len);
+    ok(hr == S_OK, "get_length failed: %#x\n", hr);
+    ok(len == 99, "len %d\n", len);
+    expect_list_item(node_list, 50, "b51");
+    expect_list_item(node_list, 49, "b49");
+    expect_list_item(node_list, 98, "b99");
+    expect_list_item(node_list, 99, NULL);
+
+    hr = IXMLDOMNodeList_get_item(node_list, 10, &node2);
+    ok(hr == S_OK, "get_item failed: %#x\n", hr);
+    V_VT(&v) = VT_UNKNOWN;
+    V_UNKNOWN(&v) = (IUnknown*)node2;
+    hr = IXMLDOMElement_insertBefore(element, node, v, NULL);
+    ok(hr == S_OK, "insertBefore failed: %#x\n", hr);
+    IXMLDOMNode_Release(node2);
+
+    hr = IXMLDOMNodeList_get_length(node_list, &len);
+    ok(hr == S_OK, "get_length failed: %#x\n", hr);
+    ok(len == 100, "len %d\n", len);
+    expect_list_item(node_list, 9, "b9");
+    expect_list_item(node_list, 10, "b50");
+    expect_list_item(node_list, 11, "b10");
+    expect_list_item(node_list, 50, "b49");
+    expect_list_item(node_list, 51, "b51");
+
+    hr = IXMLDOMElement_appendChild(element, node, NULL);
+    ok(hr == S_OK, "appendChild failed: %#x\n", hr);
+    IXMLDOMNode_Release(node);
+    expect_list_item(node_list, 10, "b10");
+    expect_list_item(node_list, 99, "b50");
+    expect_list_item(node_list, 98, "b99");
+
+    hr = IXMLDOMElement_put_text(element, _bstr_("text"));
+    ok(hr == S_OK, "put_text failed: %#x\n", hr);
+    hr = IXMLDOMNodeList_get_length(node_list, &len);
+    ok(hr == S_OK, "get_length failed: %#x\n", hr);
+    ok(len == 1, "len %d\n", len);
+    expect_list_item(node_list, 0, "#text");
+    expect_list_item(node_list, 1, NULL);
+
+    IXMLDOMNodeList_Release(node_list);
+    IXMLDOMElement_Release(element);
+    IXMLDOMDocument_Release(doc);
+    free_bstrs();
+}
+
+/* Loads a document of about 100MB and walks its children, only run in interactive mode. */
+static void test_large_document_benchmark(void)
+{
+    static const char item_fmt[] = "<item id=\"%u\" type=\"benchmark\">text %u</item>\n";
+    static const unsigned item_cnt = 2000000;
+    IXMLDOMNodeList *node_list;
+    IXMLDOMElement *element;
+    IXMLDOMDocument *doc;
+    IXMLDOMNode *node;
+    DWORD start, size, i;
+    VARIANT_BOOL b;
+    char *buf, *p;
+    HRESULT hr;
+    LONG len;
+    BSTR str;
+
+    size = item_cnt * (sizeof(item_fmt) + 20) + 16;
+    p = buf = HeapAlloc(GetProcessHeap(), 0, size);
+    p += sprintf(p, "<root>\n");
+    for (i = 0; i < item_cnt; i++)
+        p += sprintf(p, item_fmt, i, i);
+    p += sprintf(p, "</root>");
+
+    size = MultiByteToWideChar(CP_ACP, 0, buf, p - buf, NULL, 0);
+    str = SysAllocStringLen(NULL, size);
+    MultiByteToWideChar(CP_ACP, 0, buf, p - buf, str, size);
+    HeapFree(GetProcessHeap(), 0, buf);
+    trace("document size %u MB\n", (DWORD)(size * sizeof(WCHAR) >> 20));
+
+    doc = create_document(&IID_IXMLDOMDocument);
+
+    start = GetTickCount();
+    hr = IXMLDOMDocument_loadXML(doc, str, &b);
+    ok(hr == S_OK, "loadXML failed: %#x\n", hr);
+    ok(b == VARIANT_TRUE, "failed to load XML string\n");
+    trace("loadXML took %u ms\n", GetTickCount() - start);
+    SysFreeString(str);
+
+    hr = IXMLDOMDocument_get_documentElement(doc, &element);
+    ok(hr == S_OK, "get_documentElement failed: %#x\n", hr);
+    hr = IXMLDOMElement_get_childNodes(element, &node_list);
+    ok(hr == S_OK, "get_childNodes failed: %#x\n", hr);
+
+    start = GetTickCount();
+    hr = IXMLDOMNodeList_get_length(node_list, &len);
+    ok(hr == S_OK, "get_length failed: %#x\n", hr);
+    for (i = 0; i < len; i++)
+    {
+        hr = IXMLDOMNodeList_get_item(node_list, i, &node);
+        ok(hr == S_OK, "get_item(%u) failed: %#x\n", i, hr);
+        IXMLDOMNode_Release(node);
+    }
+    trace("item() loop over %d nodes took %u ms\n", len, GetTickCount() - start);
+
+    start = GetTickCount();
+    i = 0;
+    while (IXMLDOMNodeList_nextNode(node_list, &node) == S_OK)
+    {
+        IXMLDOMNode_Release(node);
+        i++;
+    }
+    ok(i == len, "got %u nodes\n", i);
+    trace("nextNode() loop took %u ms\n", GetTickCount() - start);
+
+    IXMLDOMNodeList_Release(node_list);
+    IXMLDOMElement_Release(element);
+    IXMLDOMDocument_Release(doc);
+}
+
 static void test_get_firstChild(void)
 {
     static const WCHAR xmlW[] = {'x','m','l',0};
@@ -7389,6 +7586,81 @@ static const xslpattern_test_t xslpattern_test_func[] = {
     { NULL }
 };
 
+static void test_selectNodes_repeated(void)
+{
+    IXMLDOMDocument2 *doc;
+    IXMLDOMNodeList *list;
+    IXMLDOMNode *node, *node2;
+    VARIANT_BOOL b;
+    char query[32];
+    HRESULT hr;
+    int i;
+
+    doc = create_document(&IID_IXMLDOMDocument2);
+
+    hr = IXMLDOMDocument2_loadXML(doc, _bstr_(szExampleXML), &b);
+    EXPECT_HR(hr, S_OK);
+    ok(b == VARIANT_TRUE, "failed to load XML string\n");
+
+    hr = IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionLanguage"), _variantbstr_("XSLPattern"));
+    EXPECT_HR(hr, S_OK);
+
+    for (i = 0; i < 10; i++)
+    {
+        hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("//foo:c"), &list);
+        EXPECT_HR(hr, S_OK);
+        expect_list_and_release(list, "E3.E4.E2.D1");
+    }
+
+    /* same query string, different meaning once the prefix is registered */
+    ole_check(IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionNamespaces"),
+        _variantbstr_("xmlns:foo='urn:uuid:86B2F87F-ACB6-45cd-8B77-9BDB92A01A29'")));
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("//foo:c"), &list);
+    EXPECT_HR(hr, S_OK);
+    expect_list_and_release(list, "E3.E3.E2.D1 E3.E4.E2.D1");
+
+    ole_check(IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionNamespaces"), _variantbstr_("")));
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("//foo:c"), &list);
+    EXPECT_HR(hr, S_OK);
+    expect_list_and_release(list, "E3.E4.E2.D1");
+
+    /* and in XPath mode the unregistered prefix is an error */
+    ole_check(IXMLDOMDocument2_setProperty(doc, _bstr_("SelectionLanguage"), _variantbstr_("XPath")));
+    ole_expect(IXMLDOMDocument2_selectNodes(doc, _bstr_("//foo:c"), &list), E_FAIL);
+
+    /* enough distinct queries to push the first ones out */
+    for (i = 0; i < 40; i++)
+    {
+        sprintf(query, "root/elem[%d]", i % 4 + 1);
+        if (i >= 4) sprintf(query + strlen(query), "[%d]", i);
+        hr = IXMLDOMDocument2_selectNodes(doc, _bstr_(query), &list);
+        EXPECT_HR(hr, S_OK);
+        IXMLDOMNodeList_Release(list);
+    }
+
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("root/elem[2]/c"), &list);
+    EXPECT_HR(hr, S_OK);
+    expect_list_and_release(list, "E3.E2.E2.D1");
+
+    /* results reflect the current tree */
+    hr = IXMLDOMDocument2_selectSingleNode(doc, _bstr_("root/elem[2]"), &node);
+    EXPECT_HR(hr, S_OK);
+    hr = IXMLDOMNode_selectSingleNode(node, _bstr_("c"), &node2);
+    EXPECT_HR(hr, S_OK);
+    hr = IXMLDOMNode_removeChild(node, node2, NULL);
+    EXPECT_HR(hr, S_OK);
+    IXMLDOMNode_Release(node2);
+    IXMLDOMNode_Release(node);
+
+    hr = IXMLDOMDocument2_selectNodes(doc, _bstr_("root/elem[2]/c"), &list);
+    EXPECT_HR(hr, S_OK);
+    EXPECT_LIST_LEN(list, 0);
+    IXMLDOMNodeList_Release(list);
+
+    IXMLDOMDocument2_Release(doc);
+    free_bstrs();
+}
+
 static void test_XSLPattern(void)
 {
     const xslpattern_test_t *ptr = xslpattern_test;
@@ -13278,6 +13550,7 @@ START_TEST(domdoc)
     test_getElementsByTagName();
     test_get_text();
     test_get_childNodes();
+    test_childNodes_index();
     test_get_firstChild();
     test_get_lastChild();
     test_removeChild();
@@ -13287,6 +13560,7 @@ START_TEST(domdoc)
     test_whitespace();
     test_XPath();
     test_XSLPattern();
+    test_selectNodes_repeated();
     test_cloneNode();
     test_xmlTypes();
     test_save();
@@ -13349,5 +13623,8 @@ START_TEST(domdoc)
         test_mxnamespacemanager_override();
     }
 
+    if (winetest_interactive)
+        test_large_document_benchmark();
+
     CoUninitialize();
 }
@@ -421,6 +421,7 @@ static HRESULT WINAPI xmlelem_put_text(IXMLElement *iface, BSTR p)
 
     content = xmlchar_from_wchar(p);
     xmlNodeSetContent(This->node, content);
+    node_tree_modified();
 
     heap_free(content);
 
@@ -442,7 +443,11 @@ static HRESULT WINAPI xmlelem_addChild(IXMLElement *iface, IXMLElement *pChildEl
         child = xmlAddNextSibling(This->node, childElem->node->last);
 
     /* parent is responsible for child data */
-    if (child) childElem->own = FALSE;
+    if (child)
+    {
+        childElem->own = FALSE;
+        node_tree_modified();
+    }
 
     return (child) ? S_OK : S_FALSE;
 }
@@ -462,6 +467,7 @@ static HRESULT WINAPI xmlelem_removeChild(IXMLElement *iface, IXMLElement *pChil
         return E_INVALIDARG;
 
     xmlUnlinkNode(childElem->node);
+    node_tree_modified();
     /* standalone element now */
     childElem->own = TRUE;
 
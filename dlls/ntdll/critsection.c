@@ -33,10 +33,11 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(ntdll);
 WINE_DECLARE_DEBUG_CHANNEL(relay);
+WINE_DECLARE_DEBUG_CHANNEL(critsect);
 
 static inline void small_pause(void)
 {
-#ifdef __i386__
+#if defined(__i386__) || defined(__x86_64__)
     __asm__ __volatile__( "rep;nop" : : : "memory" );
 #else
     __asm__ __volatile__( "" : : : "memory" );
@@ -50,6 +51,153 @@ static BOOL crit_section_has_debuginfo(const RTL_CRITICAL_SECTION *crit)
     return crit->DebugInfo != NULL && crit->DebugInfo != no_debug_info_marker;
 }
 
+/* upper bound of the adaptive spinning, same as the default used by Windows */
+#define MAX_ADAPTIVE_SPIN_COUNT 2000
+
+/* Running average of the spin length, stored in memory that isn't part of the
+ * public debug info: the second spare word on 32-bit, and on 64-bit, where
+ * Spare[0] holding the name fills the spare space, the alignment padding
+ * after CreatorBackTraceIndex. */
+#ifdef _WIN64
+C_ASSERT( offsetof( RTL_CRITICAL_SECTION_DEBUG, CriticalSection ) >=
+          offsetof( RTL_CRITICAL_SECTION_DEBUG, CreatorBackTraceIndex ) + sizeof(WORD) + sizeof(LONG) );
+#else
+C_ASSERT( ARRAY_SIZE( ((RTL_CRITICAL_SECTION_DEBUG *)0)->Spare ) >= 2 );
+#endif
+
+static inline LONG *crit_section_spin_avg( RTL_CRITICAL_SECTION_DEBUG *debug )
+{
+#ifdef _WIN64
+    return (LONG *)((char *)debug + offsetof( RTL_CRITICAL_SECTION_DEBUG, CriticalSection ) - sizeof(LONG));
+#else
+    return (LONG *)&debug->Spare[1];
+#endif
+}
+
+/***********************************************************************
+ *           crit_section_spin
+ *
+ * Spin for a while waiting for the section to become free. Sections with
+ * debug info spin for at most twice the number of iterations the previous
+ * acquisitions needed, so that sections held for a long time quickly stop
+ * wasting cycles while briefly held ones still avoid going to sleep. Spins
+ * that succeed move the average towards their length, spins that fail decay
+ * it, so it only grows for sections that are released while spinning. The
+ * average is only a hint, updating it without synchronization is fine.
+ */
+static BOOL crit_section_spin( RTL_CRITICAL_SECTION *crit )
+{
+    RTL_CRITICAL_SECTION_DEBUG *debug = NULL;
+    ULONG count, limit = crit->SpinCount;
+    int avg = 0;
+
+    if (crit_section_has_debuginfo( crit ) && NtCurrentTeb()->Peb->NumberOfProcessors > 1)
+    {
+        debug = crit->DebugInfo;
+        avg = *crit_section_spin_avg( debug );
+        if (!limit || limit > MAX_ADAPTIVE_SPIN_COUNT) limit = MAX_ADAPTIVE_SPIN_COUNT;
+        limit = min( limit, 2 * avg + 10 );
+    }
+    if (!limit) return FALSE;
+
+    for (count = 0; count < limit; count++)
+    {
+        if (crit->LockCount > 0) break;  /* more than one waiter, don't bother spinning */
+        if (crit->LockCount == -1)       /* try again */
+        {
+            if (InterlockedCompareExchange( &crit->LockCount, 0, -1 ) == -1)
+            {
+                if (debug) *crit_section_spin_avg( debug ) = avg + ((int)count - avg) / 8;
+                return TRUE;
+            }
+        }
+        small_pause();
+    }
+    if (debug) *crit_section_spin_avg( debug ) = avg - avg / 8;
+    return FALSE;
+}
+
+/* contention profiling, enabled with WINEDEBUG=+critsect */
+
+struct crit_section_profile
+{
+    RTL_CRITICAL_SECTION *crit;
+    const char           *name;
+    ULONG                 contentions;
+    LONGLONG              total_wait;   /* in performance counter ticks */
+    LONGLONG              max_wait;
+    void                 *owner;        /* caller of the current owner */
+    void                 *max_owner;    /* owner caller during the longest wait */
+    DWORD                 max_owner_tid;
+};
+
+#define PROFILE_TABLE_SIZE 4096
+
+static struct crit_section_profile *profile_table;
+
+static struct crit_section_profile *get_crit_section_profile( RTL_CRITICAL_SECTION *crit, BOOL create )
+{
+    struct crit_section_profile *table = profile_table;
+    ULONG i, hash = ((ULONG_PTR)crit >> 4) % PROFILE_TABLE_SIZE;
+
+    if (!table)
+    {
+        SIZE_T size = PROFILE_TABLE_SIZE * sizeof(*table);
+
+        if (!create) return NULL;
+        if (NtAllocateVirtualMemory( GetCurrentProcess(), (void **)&table, 0, &size,
+                                     MEM_COMMIT, PAGE_READWRITE )) return NULL;
+        if (InterlockedCompareExchangePointer( (void **)&profile_table, table, NULL ))
+        {
+            size = 0;
+            NtFreeVirtualMemory( GetCurrentProcess(), (void **)&table, &size, MEM_RELEASE );
+            table = profile_table;
+        }
+    }
+
+    /* entries are never removed, so a lock-free linear probe is enough */
+    for (i = 0; i < PROFILE_TABLE_SIZE; i++)
+    {
+        struct crit_section_profile *entry = &table[(hash + i) % PROFILE_TABLE_SIZE];
+
+        if (entry->crit == crit) return entry;
+        if (entry->crit) continue;
+        if (!create) return NULL;
+        if (!InterlockedCompareExchangePointer( (void **)&entry->crit, crit, NULL ) ||
+            entry->crit == crit)
+            return entry;
+    }
+    return NULL;
+}
+
+static void dump_crit_section_profile( struct crit_section_profile *entry )
+{
+    LARGE_INTEGER counter, freq;
+
+    if (!entry->contentions) return;
+    NtQueryPerformanceCounter( &counter, &freq );
+    TRACE_(critsect)( "section %p %s: %u contentions, %s us total wait, %s us max wait, "
+                      "blocked by %04x called from %p\n",
+                      entry->crit, debugstr_a(entry->name), entry->contentions,
+                      wine_dbgstr_longlong( entry->total_wait * 1000000 / freq.QuadPart ),
+                      wine_dbgstr_longlong( entry->max_wait * 1000000 / freq.QuadPart ),
+                      entry->max_owner_tid, entry->max_owner );
+}
+
+/***********************************************************************
+ *           dump_crit_section_profiles
+ *
+ * Print the statistics of all contended critical sections.
+ */
+void dump_crit_section_profiles(void)
+{
+    ULONG i;
+
+    if (!profile_table) return;
+    for (i = 0; i < PROFILE_TABLE_SIZE; i++)
+        if (profile_table[i].crit) dump_crit_section_profile( &profile_table[i] );
+}
+
 /***********************************************************************
  *           RtlInitializeCriticalSection   (NTDLL.@)
  *
@@ -121,7 +269,7 @@ NTSTATUS WINAPI RtlInitializeCriticalSectionAndSpinCount( RTL_CRITICAL_SECTION *
  */
 NTSTATUS WINAPI RtlInitializeCriticalSectionEx( RTL_CRITICAL_SECTION *crit, ULONG spincount, ULONG flags )
 {
-    if (flags & (RTL_CRITICAL_SECTION_FLAG_DYNAMIC_SPIN|RTL_CRITICAL_SECTION_FLAG_STATIC_INIT))
+    if (flags & RTL_CRITICAL_SECTION_FLAG_STATIC_INIT)
         FIXME("(%p,%u,0x%08x) semi-stub\n", crit, spincount, flags);
 
     /* FIXME: if RTL_CRITICAL_SECTION_FLAG_STATIC_INIT is given, we should use
@@ -145,6 +293,7 @@ NTSTATUS WINAPI RtlInitializeCriticalSectionEx( RTL_CRITICAL_SECTION *crit, ULON
             crit->DebugInfo->EntryCount = 0;
             crit->DebugInfo->ContentionCount = 0;
             memset( crit->DebugInfo->Spare, 0, sizeof(crit->DebugInfo->Spare) );
+            *crit_section_spin_avg( crit->DebugInfo ) = 0;
         }
     }
     crit->LockCount      = -1;
@@ -207,6 +356,20 @@ NTSTATUS WINAPI RtlDeleteCriticalSection( RTL_CRITICAL_SECTION *crit )
     crit->LockCount      = -1;
     crit->RecursionCount = 0;
     crit->OwningThread   = 0;
+    if (TRACE_ON(critsect))
+    {
+        struct crit_section_profile *profile = get_crit_section_profile( crit, FALSE );
+
+        /* report the statistics now, the address may be reused by another section */
+        if (profile)
+        {
+            dump_crit_section_profile( profile );
+            profile->name = NULL;
+            profile->contentions = 0;
+            profile->total_wait = profile->max_wait = 0;
+            profile->owner = profile->max_owner = NULL;
+        }
+    }
     if (crit_section_has_debuginfo( crit ))
     {
         /* only free the ones we made in here */
@@ -248,6 +411,10 @@ NTSTATUS WINAPI RtlDeleteCriticalSection( RTL_CRITICAL_SECTION *crit )
 NTSTATUS WINAPI RtlpWaitForCriticalSection( RTL_CRITICAL_SECTION *crit )
 {
     LONGLONG timeout = NtCurrentTeb()->Peb->CriticalSectionTimeout.QuadPart / -10000000;
+    struct crit_section_profile *profile = NULL;
+    LARGE_INTEGER start, end;
+    DWORD owner_tid = 0;
+    void *owner = NULL;
 
     /* Don't allow blocking on a critical section during process termination */
     if (RtlDllShutdownInProgress())
@@ -257,6 +424,15 @@ NTSTATUS WINAPI RtlpWaitForCriticalSection( RTL_CRITICAL_SECTION *crit )
         return STATUS_SUCCESS;
     }
 
+    if (TRACE_ON(critsect) && (profile = get_crit_section_profile( crit, TRUE )))
+    {
+        if (!profile->name && crit_section_has_debuginfo( crit ))
+            profile->name = (const char *)crit->DebugInfo->Spare[0];
+        owner_tid = HandleToULong( crit->OwningThread );
+        owner = profile->owner;
+        NtQueryPerformanceCounter( &start, NULL );
+    }
+
     for (;;)
     {
         EXCEPTION_RECORD rec;
@@ -298,6 +474,20 @@ NTSTATUS WINAPI RtlpWaitForCriticalSection( RTL_CRITICAL_SECTION *crit )
         RtlRaiseException( &rec );
     }
     if (crit_section_has_debuginfo( crit )) crit->DebugInfo->ContentionCount++;
+    if (profile)
+    {
+        /* we own the section now, so the statistics don't need to be updated atomically */
+        NtQueryPerformanceCounter( &end, NULL );
+        end.QuadPart -= start.QuadPart;
+        profile->contentions++;
+        profile->total_wait += end.QuadPart;
+        if (end.QuadPart >= profile->max_wait)
+        {
+            profile->max_wait = end.QuadPart;
+            profile->max_owner = owner;
+            profile->max_owner_tid = owner_tid;
+        }
+    }
     return STATUS_SUCCESS;
 }
 
@@ -353,20 +543,11 @@ NTSTATUS WINAPI RtlpUnWaitCriticalSection( RTL_CRITICAL_SECTION *crit )
  */
 NTSTATUS WINAPI RtlEnterCriticalSection( RTL_CRITICAL_SECTION *crit )
 {
-    if (crit->SpinCount)
+    if (crit->SpinCount || crit_section_has_debuginfo( crit ))
     {
-        ULONG count;
-
-        if (RtlTryEnterCriticalSection( crit )) return STATUS_SUCCESS;
-        for (count = crit->SpinCount; count > 0; count--)
-        {
-            if (crit->LockCount > 0) break;  /* more than one waiter, don't bother spinning */
-            if (crit->LockCount == -1)       /* try again */
-            {
-                if (InterlockedCompareExchange( &crit->LockCount, 0, -1 ) == -1) goto done;
-            }
-            small_pause();
-        }
+        if (InterlockedCompareExchange( &crit->LockCount, 0, -1 ) == -1) goto done;
+        if (crit->OwningThread != ULongToHandle(GetCurrentThreadId()) && crit_section_spin( crit ))
+            goto done;
     }
 
     if (InterlockedIncrement( &crit->LockCount ))
@@ -383,6 +564,11 @@ NTSTATUS WINAPI RtlEnterCriticalSection( RTL_CRITICAL_SECTION *crit )
 done:
     crit->OwningThread   = ULongToHandle(GetCurrentThreadId());
     crit->RecursionCount = 1;
+    if (TRACE_ON(critsect))
+    {
+        struct crit_section_profile *profile = get_crit_section_profile( crit, FALSE );
+        if (profile) profile->owner = __builtin_return_address( 0 );
+    }
     return STATUS_SUCCESS;
 }
 
@@ -3162,6 +3162,7 @@ fail:
 void WINAPI LdrShutdownProcess(void)
 {
     TRACE("()\n");
+    dump_crit_section_profiles();
     process_detaching = TRUE;
     process_detach();
 }
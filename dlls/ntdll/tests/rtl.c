@@ -3079,6 +3079,126 @@ static void test_RtlInitializeCriticalSectionEx(void)
     RtlDeleteCriticalSection(&cs);
 }
 
+struct crit_section_contention
+{
+    RTL_CRITICAL_SECTION cs;
+    LONG inside;
+    LONG errors;
+    LONG counter;
+};
+
+static DWORD WINAPI crit_section_contention_thread(void *arg)
+{
+    struct crit_section_contention *data = arg;
+    int i, j;
+
+    for (i = 0; i < 10000; i++)
+    {
+        RtlEnterCriticalSection(&data->cs);
+        if (InterlockedIncrement(&data->inside) != 1) InterlockedIncrement(&data->errors);
+        for (j = 0; j < (i % 16); j++) data->counter++;
+        data->counter -= j - 1;
+        InterlockedDecrement(&data->inside);
+        RtlLeaveCriticalSection(&data->cs);
+    }
+    return 0;
+}
+
+struct crit_section_holder
+{
+    RTL_CRITICAL_SECTION cs;
+    HANDLE entered;
+    HANDLE released;
+};
+
+static DWORD WINAPI crit_section_holder_thread(void *arg)
+{
+    struct crit_section_holder *data = arg;
+    int i;
+
+    for (i = 0; i < 20; i++)
+    {
+        RtlEnterCriticalSection(&data->cs);
+        SetEvent(data->entered);
+        Sleep(5);
+        RtlLeaveCriticalSection(&data->cs);
+        WaitForSingleObject(data->released, INFINITE);
+    }
+    return 0;
+}
+
+static void test_RtlEnterCriticalSection_contention(void)
+{
+    static const struct
+    {
+        ULONG spincount;
+        ULONG flags;
+    }
+    tests[] =
+    {
+        { 0, 0 },
+        { 4000, 0 },
+        { 0, RTL_CRITICAL_SECTION_FLAG_NO_DEBUG_INFO },
+        { 0, RTL_CRITICAL_SECTION_FLAG_DYNAMIC_SPIN },
+    };
+    struct crit_section_contention data;
+    struct crit_section_holder holder;
+    HANDLE threads[4], thread;
+    unsigned int i, j;
+    NTSTATUS status;
+
+    if (!pRtlInitializeCriticalSectionEx)
+    {
+        win_skip("RtlInitializeCriticalSectionEx is not available\n");
+        return;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(tests); i++)
+    {
+        memset(&data, 0, sizeof(data));
+        status = pRtlInitializeCriticalSectionEx(&data.cs, tests[i].spincount, tests[i].flags);
+        ok(!status, "%u: RtlInitializeCriticalSectionEx failed: %x\n", i, status);
+
+        for (j = 0; j < ARRAY_SIZE(threads); j++)
+            threads[j] = CreateThread(NULL, 0, crit_section_contention_thread, &data, 0, NULL);
+        for (j = 0; j < ARRAY_SIZE(threads); j++)
+        {
+            ok(!WaitForSingleObject(threads[j], 20000), "%u: wait failed\n", i);
+            CloseHandle(threads[j]);
+        }
+
+        ok(!data.errors, "%u: section was entered by more than one thread %d times\n", i, data.errors);
+        ok(data.counter == ARRAY_SIZE(threads) * 10000, "%u: got counter %d\n", i, data.counter);
+        ok(data.cs.LockCount == -1, "%u: expected LockCount == -1, got %d\n", i, data.cs.LockCount);
+        ok(!data.cs.RecursionCount, "%u: expected RecursionCount == 0, got %d\n", i, data.cs.RecursionCount);
+        RtlDeleteCriticalSection(&data.cs);
+    }
+
+    /* waiting on a section that is held for a long time, every wait must
+     * eventually get the section */
+    RtlInitializeCriticalSection(&holder.cs);
+    holder.entered = CreateEventA(NULL, FALSE, FALSE, NULL);
+    holder.released = CreateEventA(NULL, FALSE, FALSE, NULL);
+    thread = CreateThread(NULL, 0, crit_section_holder_thread, &holder, 0, NULL);
+    for (i = j = 0; i < 20; i++)
+    {
+        if (WaitForSingleObject(holder.entered, 20000)) break;
+        RtlEnterCriticalSection(&holder.cs);
+        if (holder.cs.OwningThread == ULongToHandle(GetCurrentThreadId()) && holder.cs.RecursionCount == 1) j++;
+        RtlLeaveCriticalSection(&holder.cs);
+        SetEvent(holder.released);
+    }
+    ok(j == 20, "section was entered %u times\n", j);
+    ok(!WaitForSingleObject(thread, 20000), "wait failed\n");
+    CloseHandle(thread);
+    ok(holder.cs.LockCount == -1, "expected LockCount == -1, got %d\n", holder.cs.LockCount);
+    ok(!holder.cs.RecursionCount, "expected RecursionCount == 0, got %d\n", holder.cs.RecursionCount);
+    ok(!holder.cs.OwningThread, "expected OwningThread == 0, got %p\n", holder.cs.OwningThread);
+    RtlDeleteCriticalSection(&holder.cs);
+    CloseHandle(holder.entered);
+    CloseHandle(holder.released);
+}
+
 static void test_RtlLeaveCriticalSection(void)
 {
     RTL_CRITICAL_SECTION cs;
@@ -3520,6 +3640,7 @@ START_TEST(rtl)
     test_RtlIsCriticalSectionLocked();
     test_RtlInitializeCriticalSectionEx();
     test_RtlLeaveCriticalSection();
+    test_RtlEnterCriticalSection_contention();
     test_LdrEnumerateLoadedModules();
     test_RtlMakeSelfRelativeSD();
     test_LdrRegisterDllNotification();
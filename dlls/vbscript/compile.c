@@ -164,6 +164,7 @@ static unsigned push_instr(compile_ctx_t *ctx, vbsop_t op)
 
     ctx->code->instrs[ctx->instr_cnt].op = op;
     ctx->code->instrs[ctx->instr_cnt].loc = ctx->loc;
+    ctx->code->instrs[ctx->instr_cnt].cache.type = IDENT_UNRESOLVED;
     return ctx->instr_cnt++;
 }
 
@@ -1442,6 +1443,65 @@ static HRESULT fill_array_desc(compile_ctx_t *ctx, dim_decl_t *dim_decl, array_d
     return S_OK;
 }
 
+static const WCHAR *instr_identifier(const instr_t *instr)
+{
+    switch(instr->op) {
+    case OP_assign_ident:
+    case OP_dim:
+    case OP_icall:
+    case OP_icallv:
+    case OP_incc:
+    case OP_redim:
+    case OP_set_ident:
+        return instr->arg1.bstr;
+    case OP_enumnext:
+    case OP_step:
+        return instr->arg2.bstr;
+    default:
+        return NULL;
+    }
+}
+
+/* Bind identifiers referring to the function's own variables and arguments. */
+static void resolve_local_identifiers(compile_ctx_t *ctx, function_t *func)
+{
+    const WCHAR *name;
+    instr_t *instr;
+    unsigned i;
+
+    if(func->type == FUNC_GLOBAL)
+        return;
+
+    for(instr = ctx->code->instrs + func->code_off; instr < ctx->code->instrs + ctx->instr_cnt; instr++) {
+        if(!(name = instr_identifier(instr)))
+            continue;
+
+        if((func->type == FUNC_FUNCTION || func->type == FUNC_PROPGET || func->type == FUNC_DEFGET)
+           && !wcsicmp(name, func->name)) {
+            instr->cache.type = IDENT_RET_VAL;
+            continue;
+        }
+
+        for(i = 0; i < func->var_cnt; i++) {
+            if(!wcsicmp(func->vars[i].name, name)) {
+                instr->cache.type = IDENT_LOCAL_VAR;
+                instr->cache.u.idx = i;
+                break;
+            }
+        }
+        if(i < func->var_cnt)
+            continue;
+
+        for(i = 0; i < func->arg_cnt; i++) {
+            if(!wcsicmp(func->args[i].name, name)) {
+                instr->cache.type = IDENT_LOCAL_ARG;
+                instr->cache.u.idx = i;
+                break;
+            }
+        }
+    }
+}
+
 static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *func)
 {
     HRESULT hres;
@@ -1531,6 +1591,7 @@ static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *f
         assert(array_id == func->array_cnt);
     }
 
+    resolve_local_identifiers(ctx, func);
     return S_OK;
 }
 
@@ -126,6 +126,86 @@ static BOOL lookup_global_funcs(ScriptDisp *script, const WCHAR *name, ref_t *re
     return FALSE;
 }
 
+/*
+ * Global resolutions are only cached for code without a named item context and when there
+ * are no dynamic variables, which would take precedence over them.
+ */
+static inline BOOL can_cache_global(exec_ctx_t *ctx)
+{
+    return !ctx->code->named_item && !ctx->dynamic_vars;
+}
+
+static BOOL lookup_cached_identifier(exec_ctx_t *ctx, const ident_cache_t *cache, ref_t *ref)
+{
+    switch(cache->type) {
+    case IDENT_UNRESOLVED:
+        return FALSE;
+    case IDENT_RET_VAL:
+        ref->type = REF_VAR;
+        ref->u.v = &ctx->ret_val;
+        return TRUE;
+    case IDENT_LOCAL_VAR:
+        ref->type = REF_VAR;
+        ref->u.v = ctx->vars + cache->u.idx;
+        return TRUE;
+    case IDENT_LOCAL_ARG:
+        ref->type = REF_VAR;
+        ref->u.v = ctx->args + cache->u.idx;
+        return TRUE;
+    case IDENT_CLASS_PROP:
+        /* Execute may have defined a dynamic variable shadowing the property. */
+        if(!ctx->vbthis || ctx->dynamic_vars)
+            return FALSE;
+        ref->type = REF_VAR;
+        ref->u.v = ctx->vbthis->props + cache->u.idx;
+        return TRUE;
+    default:
+        break;
+    }
+
+    if(cache->global_gen != ctx->script->global_gen || !can_cache_global(ctx))
+        return FALSE;
+
+    switch(cache->type) {
+    case IDENT_GLOBAL_VAR:
+        ref->type = cache->u.var->is_const ? REF_CONST : REF_VAR;
+        ref->u.v = &cache->u.var->v;
+        return TRUE;
+    case IDENT_GLOBAL_FUNC:
+        ref->type = REF_FUNC;
+        ref->u.f = cache->u.func;
+        return TRUE;
+    case IDENT_BUILTIN:
+        ref->type = REF_DISP;
+        ref->u.d.disp = &ctx->script->global_obj->IDispatch_iface;
+        ref->u.d.id = cache->u.id;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static void cache_global_identifier(exec_ctx_t *ctx, ident_cache_type_t type, void *ptr, DISPID id)
+{
+    ident_cache_t *cache = &ctx->instr->cache;
+
+    if(!can_cache_global(ctx))
+        return;
+
+    cache->type = type;
+    cache->global_gen = ctx->script->global_gen;
+    switch(type) {
+    case IDENT_GLOBAL_VAR:
+        cache->u.var = ptr;
+        break;
+    case IDENT_GLOBAL_FUNC:
+        cache->u.func = ptr;
+        break;
+    default:
+        cache->u.id = id;
+    }
+}
+
 static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_t invoke_type, ref_t *ref)
 {
     ScriptDisp *script_obj = ctx->script->script_obj;
@@ -134,6 +214,9 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
     DISPID id;
     HRESULT hres;
 
+    if(lookup_cached_identifier(ctx, &ctx->instr->cache, ref))
+        return S_OK;
+
     if((ctx->func->type == FUNC_FUNCTION || ctx->func->type == FUNC_PROPGET || ctx->func->type == FUNC_DEFGET)
        && !wcsicmp(name, ctx->func->name)) {
         ref->type = REF_VAR;
@@ -167,6 +250,10 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
                 if(!wcsicmp(ctx->vbthis->desc->props[i].name, name)) {
                     ref->type = REF_VAR;
                     ref->u.v = ctx->vbthis->props+i;
+                    if(!ctx->dynamic_vars) {
+                        ctx->instr->cache.type = IDENT_CLASS_PROP;
+                        ctx->instr->cache.u.idx = i;
+                    }
                     return S_OK;
                 }
             }
@@ -200,16 +287,21 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
         }
     }
 
-    if(lookup_global_vars(script_obj, name, ref))
+    if(lookup_global_vars(script_obj, name, ref)) {
+        cache_global_identifier(ctx, IDENT_GLOBAL_VAR, CONTAINING_RECORD(ref->u.v, dynamic_var_t, v), 0);
         return S_OK;
-    if(lookup_global_funcs(script_obj, name, ref))
+    }
+    if(lookup_global_funcs(script_obj, name, ref)) {
+        cache_global_identifier(ctx, IDENT_GLOBAL_FUNC, ref->u.f, 0);
         return S_OK;
+    }
 
     hres = get_builtin_id(ctx->script->global_obj, name, &id);
     if(SUCCEEDED(hres)) {
         ref->type = REF_DISP;
         ref->u.d.disp = &ctx->script->global_obj->IDispatch_iface;
         ref->u.d.id = id;
+        cache_global_identifier(ctx, IDENT_BUILTIN, NULL, id);
         return S_OK;
     }
 
@@ -275,6 +367,7 @@ static HRESULT add_dynamic_var(exec_ctx_t *ctx, const WCHAR *name,
             script_obj->global_vars_size = cnt * 2;
         }
         script_obj->global_vars[script_obj->global_vars_cnt++] = new_var;
+        ctx->script->global_gen++;
     }else {
         new_var->next = ctx->dynamic_vars;
         ctx->dynamic_vars = new_var;
@@ -2859,6 +2859,22 @@ static void test_multiple_parse(void)
                                               NULL, NULL, NULL, 0, 0, 0, NULL, NULL);
     ok(hres == S_OK, "ParseScriptText failed: %08x\n", hres);
 
+    hres = IActiveScriptParse_ParseScriptText(parser,
+                                              L"function callduplicatedfunc\n"
+                                              L"  callduplicatedfunc = duplicatedfunc()\n"
+                                              L"end function\n"
+                                              L"ok callduplicatedfunc() = 2, \"callduplicatedfunc = \" & callduplicatedfunc()\n",
+                                              NULL, NULL, NULL, 0, 0, 0, NULL, NULL);
+    ok(hres == S_OK, "ParseScriptText failed: %08x\n", hres);
+
+    hres = IActiveScriptParse_ParseScriptText(parser,
+                                              L"function duplicatedfunc\n"
+                                              L"  duplicatedfunc = 3\n"
+                                              L"end function\n"
+                                              L"ok callduplicatedfunc() = 3, \"callduplicatedfunc = \" & callduplicatedfunc()\n",
+                                              NULL, NULL, NULL, 0, 0, 0, NULL, NULL);
+    ok(hres == S_OK, "ParseScriptText failed: %08x\n", hres);
+
     IActiveScriptParse_Release(parser);
     close_script(script);
 }
@@ -2948,6 +2964,17 @@ static void run_from_res(const char *name)
     test_name = "";
 }
 
+static void run_benchmarks(void)
+{
+    DWORD start;
+
+    trace("Running benchmarks...\n");
+
+    start = GetTickCount();
+    run_from_res("bench.vbs");
+    trace("bench.vbs ran in %u ms\n", GetTickCount() - start);
+}
+
 static void run_tests(void)
 {
     HRESULT hres;
@@ -3261,6 +3288,8 @@ START_TEST(run)
         run_from_file(argv[2]);
     }else {
         run_tests();
+        if(winetest_interactive)
+            run_benchmarks();
     }
 
     CoUninitialize();
@@ -184,6 +184,7 @@ static HRESULT exec_global_code(script_ctx_t *ctx, vbscode_t *code, VARIANT *res
         code->last_class = class;
     }
 
+    ctx->global_gen++;
     code->pending_exec = FALSE;
     return exec_script(ctx, TRUE, &code->main_code, NULL, NULL, res);
 }
@@ -314,11 +315,13 @@ static void release_script(script_ctx_t *ctx)
         ctx->script_obj = NULL;
         script_obj->ctx = NULL;
         IDispatchEx_Release(&script_obj->IDispatchEx_iface);
+        ctx->global_gen++;
     }
 }
 
 static void release_code_list(script_ctx_t *ctx)
 {
+    ctx->global_gen++;
     while(!list_empty(&ctx->code_list)) {
         vbscode_t *iter = LIST_ENTRY(list_head(&ctx->code_list), vbscode_t, entry);
 
@@ -195,6 +195,9 @@ struct _script_ctx_t {
     vbscode_t *error_loc_code;
     unsigned error_loc_offset;
 
+    /* Bumped whenever global variables or functions change, see ident_cache_t. */
+    unsigned global_gen;
+
     struct list objects;
     struct list code_list;
     struct list named_items;
@@ -294,11 +297,39 @@ typedef union {
     double *dbl;
 } instr_arg_t;
 
+typedef enum {
+    IDENT_UNRESOLVED,
+    IDENT_RET_VAL,
+    IDENT_LOCAL_VAR,
+    IDENT_LOCAL_ARG,
+    IDENT_CLASS_PROP,
+    IDENT_GLOBAL_VAR,
+    IDENT_GLOBAL_FUNC,
+    IDENT_BUILTIN
+} ident_cache_type_t;
+
+/*
+ * Resolution of the identifier used by an instruction. Locals and arguments
+ * are resolved by the compiler, other identifiers when they are first looked
+ * up. Global resolutions are valid as long as global_gen doesn't change.
+ */
+typedef struct {
+    ident_cache_type_t type;
+    unsigned global_gen;
+    union {
+        unsigned idx;
+        DISPID id;
+        dynamic_var_t *var;
+        function_t *func;
+    } u;
+} ident_cache_t;
+
 typedef struct {
     vbsop_t op;
     unsigned loc;
     instr_arg_t arg1;
     instr_arg_t arg2;
+    ident_cache_t cache;
 } instr_t;
 
 typedef struct {
@@ -57,6 +57,8 @@ static RTL_CRITICAL_SECTION vcomp_section = { &critsect_debug, -1, 0, 0, 0, 0 };
 #define VCOMP_DYNAMIC_FLAGS_GUIDED      0x03
 #define VCOMP_DYNAMIC_FLAGS_INCREMENT   0x40
 
+#define VCOMP_BARRIER_SPIN_COUNT        4000
+
 struct vcomp_thread_data
 {
     struct vcomp_team_data  *team;
@@ -94,8 +96,8 @@ struct vcomp_team_data
     __ms_va_list            valist;
 
     /* barrier */
-    unsigned int            barrier;
-    int                     barrier_count;
+    volatile LONG           barrier;
+    volatile LONG           barrier_count;
 };
 
 struct vcomp_task_data
@@ -115,6 +117,8 @@ struct vcomp_task_data
     unsigned int            dynamic_iterations;
     int                     dynamic_step;
     unsigned int            dynamic_chunksize;
+    /* loop counter in the high and remaining iterations in the low 32 bits */
+    LONGLONG volatile       dynamic_state;
 };
 
 #if defined(__i386__)
@@ -366,6 +370,29 @@ static short interlocked_xchg_add16(short *dest, short incr)
 
 #endif  /* __GNUC__ */
 
+static inline void small_pause(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__( "rep;nop" : : : "memory" );
+#else
+    __asm__ __volatile__( "" : : : "memory" );
+#endif
+}
+
+static inline LONGLONG vcomp_get_dynamic_state(struct vcomp_task_data *task_data)
+{
+#ifdef _WIN64
+    return task_data->dynamic_state;
+#else
+    return InterlockedCompareExchange64(&task_data->dynamic_state, 0, 0);
+#endif
+}
+
+static inline void vcomp_set_dynamic_state(struct vcomp_task_data *task_data, LONGLONG state)
+{
+    InterlockedExchange64(&task_data->dynamic_state, state);
+}
+
 static inline struct vcomp_thread_data *vcomp_get_thread_data(void)
 {
     return (struct vcomp_thread_data *)TlsGetValue(vcomp_context_tls);
@@ -1041,26 +1068,31 @@ void CDECL _vcomp_flush(void)
 void CDECL _vcomp_barrier(void)
 {
     struct vcomp_team_data *team_data = vcomp_init_thread_data()->team;
+    LONG barrier;
+    int count;
 
     TRACE("()\n");
 
     if (!team_data)
         return;
 
-    EnterCriticalSection(&vcomp_section);
-    if (++team_data->barrier_count >= team_data->num_threads)
+    barrier = team_data->barrier;
+    if (InterlockedIncrement(&team_data->barrier_count) >= team_data->num_threads)
     {
-        team_data->barrier++;
         team_data->barrier_count = 0;
-        WakeAllConditionVariable(&team_data->cond);
+        InterlockedIncrement(&team_data->barrier);
+        RtlWakeAddressAll((const void *)&team_data->barrier);
+        return;
     }
-    else
+
+    /* the other threads usually arrive soon, spin for a while before sleeping */
+    if (vcomp_max_threads > 1)
     {
-        unsigned int barrier = team_data->barrier;
-        while (team_data->barrier == barrier)
-            SleepConditionVariableCS(&team_data->cond, &vcomp_section, INFINITE);
+        for (count = VCOMP_BARRIER_SPIN_COUNT; count > 0 && team_data->barrier == barrier; count--)
+            small_pause();
     }
-    LeaveCriticalSection(&vcomp_section);
+    while (team_data->barrier == barrier)
+        RtlWaitOnAddress((const void *)&team_data->barrier, &barrier, sizeof(barrier), NULL);
 }
 
 void CDECL _vcomp_set_num_threads(int num_threads)
@@ -1337,6 +1369,7 @@ void CDECL _vcomp_for_dynamic_init(unsigned int flags, unsigned int first, unsig
             task_data->dynamic_iterations   = iterations;
             task_data->dynamic_step         = step;
             task_data->dynamic_chunksize    = chunksize;
+            vcomp_set_dynamic_state(task_data, ((LONGLONG)thread_data->dynamic << 32) | iterations);
         }
         LeaveCriticalSection(&vcomp_section);
     }
@@ -1361,26 +1394,39 @@ int CDECL _vcomp_for_dynamic_next(unsigned int *begin, unsigned int *end)
     else if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_CHUNKED ||
              thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED)
     {
-        unsigned int iterations = 0;
-        EnterCriticalSection(&vcomp_section);
-        if (thread_data->dynamic == task_data->dynamic &&
-            task_data->dynamic_iterations != 0)
+        unsigned int iterations, remaining, first;
+        LONGLONG state, new_state;
+
+        /* grab the next chunk without taking vcomp_section, the loop counter in
+         * dynamic_state makes the exchange fail if another loop was started */
+        state = vcomp_get_dynamic_state(task_data);
+        for (;;)
         {
-            iterations = min(task_data->dynamic_iterations, task_data->dynamic_chunksize);
+            remaining = (DWORD)state;
+            if ((unsigned int)(state >> 32) != thread_data->dynamic || !remaining)
+                return 0;
+
+            iterations = min(remaining, task_data->dynamic_chunksize);
             if (thread_data->dynamic_type == VCOMP_DYNAMIC_FLAGS_GUIDED &&
-                task_data->dynamic_iterations > num_threads * task_data->dynamic_chunksize)
+                remaining > num_threads * task_data->dynamic_chunksize)
             {
-                iterations = (task_data->dynamic_iterations + num_threads - 1) / num_threads;
+                iterations = (remaining + num_threads - 1) / num_threads;
             }
-            *begin = task_data->dynamic_first;
-            *end   = task_data->dynamic_first + (iterations - 1) * task_data->dynamic_step;
-            task_data->dynamic_iterations -= iterations;
-            task_data->dynamic_first      += iterations * task_data->dynamic_step;
-            if (!task_data->dynamic_iterations)
-                *end = task_data->dynamic_last;
+            first = task_data->dynamic_first + (task_data->dynamic_iterations - remaining) *
+                    task_data->dynamic_step;
+            new_state = state - iterations;
+
+            if ((new_state = InterlockedCompareExchange64(&task_data->dynamic_state,
+                                                          new_state, state)) == state)
+                break;
+            state = new_state;
         }
-        LeaveCriticalSection(&vcomp_section);
-        return iterations != 0;
+
+        *begin = first;
+        *end   = first + (iterations - 1) * task_data->dynamic_step;
+        if (iterations == remaining)
+            *end = task_data->dynamic_last;
+        return 1;
     }
 
     return 0;
@@ -1465,6 +1511,7 @@ void WINAPIV _vcomp_fork(BOOL ifval, int nargs, void *wrapper, ...)
     task_data.single            = 0;
     task_data.section           = 0;
     task_data.dynamic           = 0;
+    task_data.dynamic_state     = 0;
 
     thread_data.team            = &team_data;
     thread_data.task            = &task_data;
@@ -593,6 +593,48 @@ static void test_vcomp_fork(void)
     pomp_set_num_threads(max_threads);
 }
 
+static void CDECL barrier_cb(LONG *count, LONG *sum)
+{
+    int num_threads = pomp_get_num_threads();
+    unsigned int begin, end;
+    int i;
+
+    for (i = 0; i < 100; i++)
+    {
+        InterlockedIncrement(count);
+        p_vcomp_barrier();
+        ok(*count == (i + 1) * num_threads, "expected %d, got %d\n", (i + 1) * num_threads, *count);
+        p_vcomp_barrier();
+
+        /* back to back loops without a barrier in between */
+        p_vcomp_for_dynamic_init(VCOMP_DYNAMIC_FLAGS_CHUNKED | VCOMP_DYNAMIC_FLAGS_INCREMENT, 0, 99, 1, 3);
+        while (p_vcomp_for_dynamic_next(&begin, &end))
+            InterlockedExchangeAdd(sum, end - begin + 1);
+        p_vcomp_for_dynamic_init(VCOMP_DYNAMIC_FLAGS_GUIDED, 99, 0, 1, 1);
+        while (p_vcomp_for_dynamic_next(&begin, &end))
+            InterlockedExchangeAdd(sum, begin - end + 1);
+    }
+}
+
+static void test_vcomp_barrier(void)
+{
+    int max_threads = pomp_get_max_threads();
+    LONG count, sum;
+    int i;
+
+    for (i = 1; i <= 4; i++)
+    {
+        pomp_set_num_threads(i);
+
+        count = sum = 0;
+        p_vcomp_fork(TRUE, 2, barrier_cb, &count, &sum);
+        ok(count == 100 * i, "expected count == %d, got %d\n", 100 * i, count);
+        ok(sum == 2 * 100 * 100, "expected sum == %d, got %d\n", 2 * 100 * 100, sum);
+    }
+
+    pomp_set_num_threads(max_threads);
+}
+
 static void CDECL section_cb(LONG *a, LONG *b, LONG *c)
 {
     int i;
@@ -2217,6 +2259,7 @@ START_TEST(vcomp)
     test_omp_get_num_threads(FALSE);
     test_omp_get_num_threads(TRUE);
     test_vcomp_fork();
+    test_vcomp_barrier();
     test_vcomp_sections_init();
     test_vcomp_for_static_simple_init();
     test_vcomp_for_static_init();
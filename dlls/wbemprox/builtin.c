@@ -1746,12 +1746,14 @@ static BOOL seen_dir( struct dirstack *dirstack, const WCHAR *path )
     return FALSE;
 }
 
-/* optimize queries of the form WHERE Name='...' [OR Name='...']* */
-static UINT seed_dirs( struct dirstack *dirstack, const struct expr *cond, WCHAR root, UINT *count )
+/* optimize queries of the form WHERE Name='...' [OR Name='...']* [AND ...]
+ * returns FALSE if the condition doesn't restrict Name, otherwise pushes the
+ * directories on the given drive that can hold matching entries */
+static BOOL seed_dirs( struct dirstack *dirstack, const struct expr *cond, WCHAR root, UINT *count )
 {
     const struct expr *left, *right;
 
-    if (!cond || cond->type != EXPR_COMPLEX) return *count = 0;
+    if (!cond || cond->type != EXPR_COMPLEX) return FALSE;
 
     left = cond->u.expr.left;
     right = cond->u.expr.right;
@@ -1762,38 +1764,71 @@ static UINT seed_dirs( struct dirstack *dirstack, const struct expr *cond, WCHAR
         const WCHAR *str = NULL;
 
         if (left->type == EXPR_PROPVAL && right->type == EXPR_SVAL &&
-            !wcscmp( left->u.propval->name, L"Name" ) &&
-            towupper( right->u.sval[0] ) == towupper( root ))
+            !wcsicmp( left->u.propval->name, L"Name" ))
         {
             str = right->u.sval;
         }
         else if (left->type == EXPR_SVAL && right->type == EXPR_PROPVAL &&
-                 !wcscmp( right->u.propval->name, L"Name" ) &&
-                 towupper( left->u.sval[0] ) == towupper( root ))
+                 !wcsicmp( right->u.propval->name, L"Name" ))
         {
             str = left->u.sval;
         }
-        if (str && (path = build_dirname( str, &len )))
+        if (!str) return FALSE;
+
+        ++*count;
+        if (towupper( str[0] ) != towupper( root )) return TRUE;
+        if (!(path = build_dirname( str, &len ))) return FALSE;
+        if (seen_dir( dirstack, path ))
         {
-            if (seen_dir( dirstack, path ))
-            {
-                heap_free( path );
-                return ++*count;
-            }
-            else if (push_dir( dirstack, path, len )) return ++*count;
             heap_free( path );
-            return *count = 0;
+            return TRUE;
         }
+        if (push_dir( dirstack, path, len )) return TRUE;
+        heap_free( path );
+        return FALSE;
     }
     else if (cond->u.expr.op == OP_OR)
     {
-        UINT left_count = 0, right_count = 0;
+        return seed_dirs( dirstack, left, root, count ) && seed_dirs( dirstack, right, root, count );
+    }
+    else if (cond->u.expr.op == OP_AND)
+    {
+        /* extra directories or a higher count only make the search less selective */
+        return seed_dirs( dirstack, left, root, count ) || seed_dirs( dirstack, right, root, count );
+    }
+    return FALSE;
+}
+
+static BOOL uses_property( const struct expr *cond, const WCHAR *name )
+{
+    if (!cond) return FALSE;
+
+    switch (cond->type)
+    {
+    case EXPR_COMPLEX:
+        return uses_property( cond->u.expr.left, name ) || uses_property( cond->u.expr.right, name );
+    case EXPR_UNARY:
+        return uses_property( cond->u.expr.left, name );
+    case EXPR_PROPVAL:
+        return !wcsicmp( cond->u.propval->name, name );
+    default:
+        return FALSE;
+    }
+}
 
-        if (!(seed_dirs( dirstack, left, root, &left_count ))) return *count = 0;
-        if (!(seed_dirs( dirstack, right, root, &right_count ))) return *count = 0;
-        return *count += left_count + right_count;
+/* Returns whether a column has to be filled. With a condition, only the columns it refers to
+ * are needed to match the row, otherwise the columns selected by the query. */
+static BOOL need_column( const struct table *table, const struct expr *cond, const WCHAR *name )
+{
+    const struct property *prop;
+
+    if (cond) return uses_property( cond, name );
+    if (!table->proplist) return TRUE;
+    for (prop = table->proplist; prop; prop = prop->next)
+    {
+        if (!wcsicmp( prop->name, name )) return TRUE;
     }
-    return *count = 0;
+    return FALSE;
 }
 
 static WCHAR *append_path( const WCHAR *path, const WCHAR *segment, UINT *len )
@@ -1852,6 +1887,7 @@ static enum fill_status fill_datafile( struct table *table, const struct expr *c
     HANDLE handle;
     struct dirstack *dirstack;
     enum fill_status status = FILL_STATUS_UNFILTERED;
+    BOOL seeded, need_version = uses_property( cond, L"Version" );
 
     if (!resize_table( table, 8, sizeof(*rec) )) return FILL_STATUS_FAILED;
 
@@ -1865,7 +1901,12 @@ static enum fill_status fill_datafile( struct table *table, const struct expr *c
         if (GetDriveTypeW( root ) != DRIVE_FIXED) continue;
 
         num_expected_rows = 0;
-        if (!seed_dirs( dirstack, cond, root[0], &num_expected_rows )) clear_dirstack( dirstack );
+        if (!(seeded = seed_dirs( dirstack, cond, root[0], &num_expected_rows )))
+        {
+            clear_dirstack( dirstack );
+            num_expected_rows = 0;
+        }
+        else if (!peek_dir( dirstack )) continue;
 
         for (;;)
         {
@@ -1898,6 +1939,12 @@ static enum fill_status fill_datafile( struct table *table, const struct expr *c
 
                     if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
                     {
+                        /* files below the seeded directories can't match */
+                        if (seeded)
+                        {
+                            heap_free( new_path );
+                            continue;
+                        }
                         if (push_dir( dirstack, new_path, len )) continue;
                         heap_free( new_path );
                         FindClose( handle );
@@ -1906,14 +1953,16 @@ static enum fill_status fill_datafile( struct table *table, const struct expr *c
                     }
                     rec = (struct record_datafile *)(table->data + offset);
                     rec->name    = build_name( root[0], new_path );
-                    rec->version = get_file_version( rec->name );
+                    rec->version = need_version ? get_file_version( rec->name ) : NULL;
                     heap_free( new_path );
                     if (!match_row( table, row, cond, &status ))
                     {
                         free_row_values( table, row );
                         continue;
                     }
-                    else if (num_expected_rows && row == num_expected_rows - 1)
+                    /* reading the version is expensive, only do it for matching files */
+                    if (!need_version) rec->version = get_file_version( rec->name );
+                    if (num_expected_rows && row == num_expected_rows - 1)
                     {
                         row++;
                         FindClose( handle );
@@ -1980,6 +2029,7 @@ static enum fill_status fill_directory( struct table *table, const struct expr *
     HANDLE handle;
     struct dirstack *dirstack;
     enum fill_status status = FILL_STATUS_UNFILTERED;
+    BOOL seeded;
 
     if (!resize_table( table, 4, sizeof(*rec) )) return FILL_STATUS_FAILED;
 
@@ -1993,7 +2043,12 @@ static enum fill_status fill_directory( struct table *table, const struct expr *
         if (GetDriveTypeW( root ) != DRIVE_FIXED) continue;
 
         num_expected_rows = 0;
-        if (!seed_dirs( dirstack, cond, root[0], &num_expected_rows )) clear_dirstack( dirstack );
+        if (!(seeded = seed_dirs( dirstack, cond, root[0], &num_expected_rows )))
+        {
+            clear_dirstack( dirstack );
+            num_expected_rows = 0;
+        }
+        else if (!peek_dir( dirstack )) continue;
 
         for (;;)
         {
@@ -2026,17 +2081,20 @@ static enum fill_status fill_directory( struct table *table, const struct expr *
                         goto done;
                     }
 
-                    if (!(push_dir( dirstack, new_path, len )))
+                    rec = (struct record_directory *)(table->data + offset);
+                    rec->accessmask = FILE_ALL_ACCESS;
+                    rec->name       = build_name( root[0], new_path );
+
+                    /* directories below the seeded directories can't match */
+                    if (seeded) heap_free( new_path );
+                    else if (!(push_dir( dirstack, new_path, len )))
                     {
                         heap_free( new_path );
+                        free_row_values( table, row );
                         FindClose( handle );
                         status = FILL_STATUS_FAILED;
                         goto done;
                     }
-                    rec = (struct record_directory *)(table->data + offset);
-                    rec->accessmask = FILE_ALL_ACCESS;
-                    rec->name       = build_name( root[0], new_path );
-                    heap_free( new_path );
                     if (!match_row( table, row, cond, &status ))
                     {
                         free_row_values( table, row );
@@ -2611,9 +2669,26 @@ static const WCHAR *get_adaptertype( DWORD type, int *id, int *physical )
     }
 }
 
-static enum fill_status fill_networkadapter( struct table *table, const struct expr *cond )
+static void set_networkadapter_strings( const struct table *table, struct record_networkadapter *rec,
+                                        const IP_ADAPTER_ADDRESSES *aa, const struct expr *cond )
 {
     WCHAR device_id[11];
+
+    if (!rec->description && need_column( table, cond, L"Description" ))
+        rec->description = heap_strdupW( aa->Description );
+    if (!rec->device_id && need_column( table, cond, L"DeviceId" ))
+    {
+        swprintf( device_id, ARRAY_SIZE( device_id ), L"%u", aa->u.s.IfIndex );
+        rec->device_id = heap_strdupW( device_id );
+    }
+    if (!rec->mac_address && need_column( table, cond, L"MACAddress" ))
+        rec->mac_address = get_mac_address( aa->PhysicalAddress, aa->PhysicalAddressLength );
+    if (!rec->name && need_column( table, cond, L"Name" ))
+        rec->name = heap_strdupW( aa->FriendlyName );
+}
+
+static enum fill_status fill_networkadapter( struct table *table, const struct expr *cond )
+{
     struct record_networkadapter *rec;
     IP_ADAPTER_ADDRESSES *aa, *buffer;
     UINT row = 0, offset = 0, count = 0;
@@ -2644,25 +2719,26 @@ static enum fill_status fill_networkadapter( struct table *table, const struct e
         if (aa->IfType == IF_TYPE_SOFTWARE_LOOPBACK) continue;
 
         rec = (struct record_networkadapter *)(table->data + offset);
-        swprintf( device_id, ARRAY_SIZE( device_id ), L"%u", aa->u.s.IfIndex );
         rec->adaptertype          = get_adaptertype( aa->IfType, &adaptertypeid, &physical );
         rec->adaptertypeid        = adaptertypeid;
-        rec->description          = heap_strdupW( aa->Description );
-        rec->device_id            = heap_strdupW( device_id );
+        rec->description          = NULL;
+        rec->device_id            = NULL;
         rec->index                = aa->u.s.IfIndex;
         rec->interface_index      = aa->u.s.IfIndex;
-        rec->mac_address          = get_mac_address( aa->PhysicalAddress, aa->PhysicalAddressLength );
+        rec->mac_address          = NULL;
         rec->manufacturer         = L"The Wine Project";
-        rec->name                 = heap_strdupW( aa->FriendlyName );
+        rec->name                 = NULL;
         rec->netconnection_status = get_connection_status( aa->OperStatus );
         rec->physicaladapter      = physical;
         rec->pnpdevice_id         = L"PCI\\VEN_8086&DEV_100E&SUBSYS_001E8086&REV_02\\3&267A616A&1&18";
         rec->speed                = 1000000;
+        set_networkadapter_strings( table, rec, aa, cond );
         if (!match_row( table, row, cond, &status ))
         {
             free_row_values( table, row );
             continue;
         }
+        set_networkadapter_strings( table, rec, aa, NULL );
         offset += sizeof(*rec);
         row++;
     }
@@ -3034,9 +3110,28 @@ static WCHAR *get_cmdline( DWORD process_id )
     return NULL; /* FIXME handle different process case */
 }
 
-static enum fill_status fill_process( struct table *table, const struct expr *cond )
+static void set_process_strings( const struct table *table, struct record_process *rec,
+                                 const PROCESSENTRY32W *entry, const struct expr *cond )
 {
     WCHAR handle[11];
+
+    if (!rec->caption && need_column( table, cond, L"Caption" ))
+        rec->caption = heap_strdupW( entry->szExeFile );
+    if (!rec->commandline && need_column( table, cond, L"CommandLine" ))
+        rec->commandline = get_cmdline( entry->th32ProcessID );
+    if (!rec->description && need_column( table, cond, L"Description" ))
+        rec->description = heap_strdupW( entry->szExeFile );
+    if (!rec->handle && need_column( table, cond, L"Handle" ))
+    {
+        swprintf( handle, ARRAY_SIZE( handle ), L"%u", entry->th32ProcessID );
+        rec->handle = heap_strdupW( handle );
+    }
+    if (!rec->name && need_column( table, cond, L"Name" ))
+        rec->name = heap_strdupW( entry->szExeFile );
+}
+
+static enum fill_status fill_process( struct table *table, const struct expr *cond )
+{
     struct record_process *rec;
     PROCESSENTRY32W entry;
     HANDLE snap;
@@ -3059,22 +3154,24 @@ static enum fill_status fill_process( struct table *table, const struct expr *co
         }
 
         rec = (struct record_process *)(table->data + offset);
-        rec->caption        = heap_strdupW( entry.szExeFile );
-        rec->commandline    = get_cmdline( entry.th32ProcessID );
-        rec->description    = heap_strdupW( entry.szExeFile );
-        swprintf( handle, ARRAY_SIZE( handle ), L"%u", entry.th32ProcessID );
-        rec->handle         = heap_strdupW( handle );
-        rec->name           = heap_strdupW( entry.szExeFile );
+        rec->caption        = NULL;
+        rec->commandline    = NULL;
+        rec->description    = NULL;
+        rec->handle         = NULL;
+        rec->name           = NULL;
         rec->process_id     = entry.th32ProcessID;
         rec->pprocess_id    = entry.th32ParentProcessID;
         rec->thread_count   = entry.cntThreads;
         rec->workingsetsize = 0;
         rec->get_owner      = process_get_owner;
+        /* fill the strings the condition needs first, the others only for matching rows */
+        set_process_strings( table, rec, &entry, cond );
         if (!match_row( table, row, cond, &status ))
         {
             free_row_values( table, row );
             continue;
         }
+        set_process_strings( table, rec, &entry, NULL );
         offset += sizeof(*rec);
         row++;
     } while (Process32NextW( snap, &entry ));
@@ -3931,11 +4028,11 @@ static struct table builtin_classes[] =
     { L"CIM_LogicalDisk", C(col_logicaldisk), 0, 0, NULL, fill_logicaldisk },
     { L"CIM_Processor", C(col_processor), 0, 0, NULL, fill_processor },
     { L"StdRegProv", C(col_stdregprov), D(data_stdregprov) },
-    { L"Win32_BIOS", C(col_bios), 0, 0, NULL, fill_bios },
-    { L"Win32_BaseBoard", C(col_baseboard), 0, 0, NULL, fill_baseboard },
+    { L"Win32_BIOS", C(col_bios), 0, 0, NULL, fill_bios, TABLE_FLAG_CACHE },
+    { L"Win32_BaseBoard", C(col_baseboard), 0, 0, NULL, fill_baseboard, TABLE_FLAG_CACHE },
     { L"Win32_CDROMDrive", C(col_cdromdrive), 0, 0, NULL, fill_cdromdrive },
     { L"Win32_ComputerSystem", C(col_compsys), 0, 0, NULL, fill_compsys },
-    { L"Win32_ComputerSystemProduct", C(col_compsysproduct), 0, 0, NULL, fill_compsysproduct },
+    { L"Win32_ComputerSystemProduct", C(col_compsysproduct), 0, 0, NULL, fill_compsysproduct, TABLE_FLAG_CACHE },
     { L"Win32_DesktopMonitor", C(col_desktopmonitor), 0, 0, NULL, fill_desktopmonitor },
     { L"Win32_Directory", C(col_directory), 0, 0, NULL, fill_directory },
     { L"Win32_DiskDrive", C(col_diskdrive), 0, 0, NULL, fill_diskdrive },
@@ -3949,8 +4046,8 @@ static struct table builtin_classes[] =
     { L"Win32_NetworkAdapterConfiguration", C(col_networkadapterconfig), 0, 0, NULL, fill_networkadapterconfig },
     { L"Win32_OperatingSystem", C(col_operatingsystem), 0, 0, NULL, fill_operatingsystem },
     { L"Win32_PhysicalMedia", C(col_physicalmedia), D(data_physicalmedia) },
-    { L"Win32_PhysicalMemory", C(col_physicalmemory), 0, 0, NULL, fill_physicalmemory },
-    { L"Win32_PnPEntity", C(col_pnpentity), 0, 0, NULL, fill_pnpentity },
+    { L"Win32_PhysicalMemory", C(col_physicalmemory), 0, 0, NULL, fill_physicalmemory, TABLE_FLAG_CACHE },
+    { L"Win32_PnPEntity", C(col_pnpentity), 0, 0, NULL, fill_pnpentity, TABLE_FLAG_CACHE },
     { L"Win32_Printer", C(col_printer), 0, 0, NULL, fill_printer },
     { L"Win32_Process", C(col_process), 0, 0, NULL, fill_process },
     { L"Win32_Processor", C(col_processor), 0, 0, NULL, fill_processor },
@@ -3958,7 +4055,7 @@ static struct table builtin_classes[] =
     { L"Win32_SID", C(col_sid), 0, 0, NULL, fill_sid },
     { L"Win32_Service", C(col_service), 0, 0, NULL, fill_service },
     { L"Win32_SoundDevice", C(col_sounddevice), D(data_sounddevice) },
-    { L"Win32_SystemEnclosure", C(col_systemenclosure), 0, 0, NULL, fill_systemenclosure },
+    { L"Win32_SystemEnclosure", C(col_systemenclosure), 0, 0, NULL, fill_systemenclosure, TABLE_FLAG_CACHE },
     { L"Win32_VideoController", C(col_videocontroller), 0, 0, NULL, fill_videocontroller },
     { L"Win32_WinSAT", C(col_winsat), D(data_winsat) },
 };
@@ -676,6 +676,41 @@ done:
     return hr;
 }
 
+static BOOL is_cache_valid( const struct table *table )
+{
+    return table->cache_valid && GetTickCount() - table->cache_time < TABLE_CACHE_TIMEOUT;
+}
+
+static enum fill_status fill_table( struct table *table, const struct property *proplist,
+                                    const struct expr *cond )
+{
+    enum fill_status status;
+
+    if (!(table->flags & TABLE_FLAG_CACHE))
+    {
+        /* the rows only live until the next query, so providers may leave out unselected columns */
+        clear_table( table );
+        table->proplist = proplist;
+        status = table->fill( table, cond );
+        table->proplist = NULL;
+        return status;
+    }
+    if (is_cache_valid( table ))
+    {
+        TRACE("reusing rows of %s\n", debugstr_w(table->name));
+        return FILL_STATUS_UNFILTERED;
+    }
+
+    /* fill all rows so that following queries can reuse them */
+    clear_table( table );
+    if ((status = table->fill( table, NULL )) == FILL_STATUS_UNFILTERED)
+    {
+        table->cache_valid = TRUE;
+        table->cache_time  = GetTickCount();
+    }
+    return status;
+}
+
 static HRESULT exec_select_view( struct view *view )
 {
     UINT i, j = 0, len;
@@ -685,11 +720,7 @@ static HRESULT exec_select_view( struct view *view )
     if (!view->table_count) return S_OK;
 
     table = view->table[0];
-    if (table->fill)
-    {
-        clear_table( table );
-        status = table->fill( table, view->cond );
-    }
+    if (table->fill) status = fill_table( table, view->proplist, view->cond );
     if (status == FILL_STATUS_FAILED) return WBEM_E_FAILED;
     if (!table->num_rows) return S_OK;
 
@@ -1365,6 +1396,9 @@ HRESULT put_propval( const struct view *view, UINT index, const WCHAR *name, VAR
     hr = to_longlong( var, &val, &type );
     if (hr != S_OK) return hr;
 
+    /* don't hand out the modified row to other queries */
+    table->cache_valid = FALSE;
+
     row = view->result[result_index];
     return set_value( table, row, column, val, type );
 }
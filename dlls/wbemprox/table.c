@@ -305,6 +305,7 @@ void clear_table( struct table *table )
 {
     UINT i;
 
+    table->cache_valid = FALSE;
     if (!table->data) return;
 
     for (i = 0; i < table->num_rows; i++) free_row_values( table, i );
@@ -383,6 +384,9 @@ struct table *create_table( const WCHAR *name, UINT num_cols, const struct colum
     table->fill               = fill;
     table->flags              = TABLE_FLAG_DYNAMIC;
     table->refs               = 0;
+    table->cache_valid        = FALSE;
+    table->cache_time         = 0;
+    table->proplist           = NULL;
     list_init( &table->entry );
     return table;
 }
@@ -1580,6 +1580,159 @@ static void test_Win32_SoundDevice( IWbemServices *services )
     SysFreeString( wql );
 }
 
+static UINT count_objects( IWbemServices *services, const WCHAR *str )
+{
+    BSTR wql = SysAllocString( L"wql" ), query = SysAllocString( str );
+    IEnumWbemClassObject *result;
+    IWbemClassObject *obj;
+    UINT ret = 0;
+    ULONG count;
+    HRESULT hr;
+
+    hr = IWbemServices_ExecQuery( services, wql, query, 0, NULL, &result );
+    ok( hr == S_OK, "%s failed %08x\n", wine_dbgstr_w(str), hr );
+    if (hr == S_OK)
+    {
+        while (IEnumWbemClassObject_Next( result, 10000, 1, &obj, &count ) == S_OK)
+        {
+            IWbemClassObject_Release( obj );
+            ret++;
+        }
+        IEnumWbemClassObject_Release( result );
+    }
+    SysFreeString( query );
+    SysFreeString( wql );
+    return ret;
+}
+
+static void test_CIM_DataFile( IWbemServices *services )
+{
+    WCHAR dir[MAX_PATH], name[MAX_PATH * 2], str[MAX_PATH * 2 + 80];
+    BSTR wql = SysAllocString( L"wql" ), query;
+    IEnumWbemClassObject *result;
+    IWbemClassObject *obj;
+    const WCHAR *p;
+    ULONG count;
+    HRESULT hr;
+    UINT i = 0;
+
+    GetSystemDirectoryW( dir, ARRAY_SIZE(dir) );
+    lstrcatW( dir, L"\\kernel32.dll" );
+    for (p = dir; *p; p++)
+    {
+        if (*p == '\\') name[i++] = '\\';
+        name[i++] = *p;
+    }
+    name[i] = 0;
+
+    wsprintfW( str, L"SELECT * FROM CIM_DataFile WHERE Name = '%s'", name );
+    query = SysAllocString( str );
+    hr = IWbemServices_ExecQuery( services, wql, query, 0, NULL, &result );
+    ok( hr == S_OK, "got %08x\n", hr );
+    SysFreeString( query );
+
+    hr = IEnumWbemClassObject_Next( result, 10000, 1, &obj, &count );
+    ok( hr == S_OK, "got %08x\n", hr );
+    if (hr == S_OK)
+    {
+        check_property( obj, L"Name", VT_BSTR, CIM_STRING );
+        check_property( obj, L"Version", VT_BSTR, CIM_STRING );
+        IWbemClassObject_Release( obj );
+    }
+    hr = IEnumWbemClassObject_Next( result, 10000, 1, &obj, &count );
+    ok( hr == WBEM_S_FALSE, "got %08x\n", hr );
+    IEnumWbemClassObject_Release( result );
+
+    wsprintfW( str, L"SELECT * FROM CIM_DataFile WHERE Name = 'Q:\\\\nonexistent.dll' OR Name = '%s'", name );
+    count = count_objects( services, str );
+    ok( count == 1, "got %u objects\n", count );
+
+    wsprintfW( str, L"SELECT * FROM CIM_DataFile WHERE Name = '%s' AND Version = 'bogus'", name );
+    count = count_objects( services, str );
+    ok( !count, "got %u objects\n", count );
+
+    SysFreeString( wql );
+}
+
+static void test_cached_tables( IWbemServices *services )
+{
+    UINT count;
+
+    count = count_objects( services, L"SELECT * FROM Win32_BIOS" );
+    ok( count == 1, "got %u objects\n", count );
+
+    /* a filtered query must not leave a partial table behind */
+    count = count_objects( services, L"SELECT * FROM Win32_BIOS WHERE Name = 'bogus'" );
+    ok( !count, "got %u objects\n", count );
+
+    count = count_objects( services, L"SELECT * FROM Win32_BIOS" );
+    ok( count == 1, "got %u objects\n", count );
+
+    count = count_objects( services, L"SELECT * FROM Win32_SystemEnclosure WHERE Name = 'bogus'" );
+    ok( !count, "got %u objects\n", count );
+
+    count = count_objects( services, L"SELECT * FROM Win32_SystemEnclosure" );
+    ok( count == 1, "got %u objects\n", count );
+}
+
+static void test_process_projection( IWbemServices *services )
+{
+    BSTR wql = SysAllocString( L"wql" ), query;
+    IEnumWbemClassObject *result;
+    IWbemClassObject *obj;
+    WCHAR str[80];
+    ULONG count;
+    HRESULT hr;
+
+    wsprintfW( str, L"SELECT Caption FROM Win32_Process WHERE ProcessId = %u", GetCurrentProcessId() );
+    query = SysAllocString( str );
+    hr = IWbemServices_ExecQuery( services, wql, query, 0, NULL, &result );
+    ok( hr == S_OK, "got %08x\n", hr );
+    SysFreeString( query );
+
+    hr = IEnumWbemClassObject_Next( result, 10000, 1, &obj, &count );
+    ok( hr == S_OK, "got %08x\n", hr );
+    if (hr == S_OK)
+    {
+        check_property( obj, L"Caption", VT_BSTR, CIM_STRING );
+        IWbemClassObject_Release( obj );
+    }
+    hr = IEnumWbemClassObject_Next( result, 10000, 1, &obj, &count );
+    ok( hr == WBEM_S_FALSE, "got %08x\n", hr );
+    IEnumWbemClassObject_Release( result );
+
+    /* columns used by the condition must be available even if they are not selected */
+    wsprintfW( str, L"SELECT ProcessId FROM Win32_Process WHERE Handle = '%u'", GetCurrentProcessId() );
+    count = count_objects( services, str );
+    ok( count == 1, "got %u objects\n", count );
+
+    SysFreeString( wql );
+}
+
+static void test_query_performance( IWbemServices *services )
+{
+    static const WCHAR *queries[] =
+    {
+        L"SELECT * FROM Win32_Process",
+        L"SELECT Name FROM Win32_Process WHERE ProcessId = 4",
+        L"SELECT * FROM Win32_BIOS",
+        L"SELECT * FROM Win32_PnPEntity",
+        L"SELECT * FROM Win32_VideoController",
+        L"SELECT * FROM Win32_Service WHERE State = 'Running'",
+    };
+    DWORD start;
+    UINT i, j;
+
+    if (!winetest_interactive) return;
+
+    for (i = 0; i < ARRAY_SIZE(queries); i++)
+    {
+        start = GetTickCount();
+        for (j = 0; j < 20; j++) count_objects( services, queries[i] );
+        trace( "%s: %u ms per query\n", wine_dbgstr_w(queries[i]), (GetTickCount() - start) / 20 );
+    }
+}
+
 START_TEST(query)
 {
     BSTR path = SysAllocString( L"ROOT\\CIMV2" );
@@ -1612,6 +1765,7 @@ START_TEST(query)
     test_select( services );
 
     /* classes */
+    test_CIM_DataFile( services );
     test_StdRegProv( services );
     test_SystemSecurity( services );
     test_Win32_Baseboard( services );
@@ -1635,6 +1789,9 @@ START_TEST(query)
     test_Win32_SystemEnclosure( services );
     test_Win32_VideoController( services );
     test_Win32_WinSAT( services );
+    test_cached_tables( services );
+    test_process_projection( services );
+    test_query_performance( services );
 
     SysFreeString( path );
     IWbemServices_Release( services );
@@ -99,6 +99,10 @@ enum fill_status
 };
 
 #define TABLE_FLAG_DYNAMIC 0x00000001
+#define TABLE_FLAG_CACHE   0x00000002
+
+/* how long the rows of a table with TABLE_FLAG_CACHE are reused, in milliseconds */
+#define TABLE_CACHE_TIMEOUT 5000
 
 struct table
 {
@@ -112,6 +116,9 @@ struct table
     UINT flags;
     struct list entry;
     LONG refs;
+    BOOL cache_valid;
+    DWORD cache_time;
+    const struct property *proplist;    /* columns selected by the query being filled, NULL for all */
 };
 
 struct property
@@ -91,6 +91,133 @@ static inline float to_sRGB_component(float f)
     return 1.055f * powf(f, 1.0f/2.4f) - 0.055f;
 }
 
+static float srgb_gray_thresholds[256];
+static INIT_ONCE srgb_gray_init_once = INIT_ONCE_STATIC_INIT;
+
+static inline BYTE linear_gray_to_sRGB_byte(float gray)
+{
+    gray = to_sRGB_component(gray) * 255.0f;
+    return (BYTE)floorf(gray + 0.51f);
+}
+
+/* srgb_gray_thresholds[i] is the smallest linear gray value that maps to
+ * sRGB gray level i or above, which lets us replace powf() by a binary
+ * search for every pixel. */
+static BOOL WINAPI init_srgb_gray_thresholds(INIT_ONCE *once, void *param, void **context)
+{
+    static const float limit = 1.001f;
+    DWORD low, high, mid;
+    float value;
+    UINT i;
+
+    srgb_gray_thresholds[0] = 0.0f;
+    for (i = 1; i < 256; i++)
+    {
+        /* Non-negative floats are ordered like their bit patterns. */
+        low = 0;
+        memcpy(&high, &limit, sizeof(high));
+        while (low < high)
+        {
+            mid = low + (high - low) / 2;
+            memcpy(&value, &mid, sizeof(value));
+            if (linear_gray_to_sRGB_byte(value) >= i) high = mid;
+            else low = mid + 1;
+        }
+        memcpy(&srgb_gray_thresholds[i], &low, sizeof(low));
+    }
+    return TRUE;
+}
+
+static inline BYTE linear_gray_to_sRGB_byte_fast(float gray)
+{
+    UINT low = 0, high = 256, mid;
+
+    while (high - low > 1)
+    {
+        mid = (low + high) / 2;
+        if (gray >= srgb_gray_thresholds[mid]) low = mid;
+        else high = mid;
+    }
+    return low;
+}
+
+/* Computes x * alpha / 255 without a division, exact for all byte values. */
+static inline BYTE premultiply_component(BYTE x, BYTE alpha)
+{
+    UINT n = x * alpha;
+    return (n + 1 + (n >> 8)) >> 8;
+}
+
+static void premultiply_alpha(BYTE *bits, UINT stride, UINT width, UINT height)
+{
+    UINT x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *pixel = bits + stride * y;
+
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            BYTE alpha = pixel[3];
+
+            pixel[0] = premultiply_component(pixel[0], alpha);
+            pixel[1] = premultiply_component(pixel[1], alpha);
+            pixel[2] = premultiply_component(pixel[2], alpha);
+        }
+    }
+}
+
+static void unpremultiply_alpha(BYTE *bits, UINT stride, UINT width, UINT height)
+{
+    UINT recip[256], x, y, i;
+
+    /* (x * recip[alpha]) >> 16 == x * 255 / alpha for all byte values. */
+    for (i = 1; i < 256; i++)
+        recip[i] = (255 * 65536 + i - 1) / i;
+
+    for (y = 0; y < height; y++)
+    {
+        BYTE *pixel = bits + stride * y;
+
+        for (x = 0; x < width; x++, pixel += 4)
+        {
+            BYTE alpha = pixel[3];
+
+            if (alpha != 0 && alpha != 255)
+            {
+                pixel[0] = (pixel[0] * recip[alpha]) >> 16;
+                pixel[1] = (pixel[1] * recip[alpha]) >> 16;
+                pixel[2] = (pixel[2] * recip[alpha]) >> 16;
+            }
+        }
+    }
+}
+
+/* Converts 24 or 32 bpp pixels directly to sRGB gray, red_offset selects
+ * between the BGR and RGB channel orders. */
+static void convert_rows_to_8bppGray(const BYTE *src, UINT srcstride, UINT pixel_size, UINT red_offset,
+    BYTE *dst, UINT dststride, UINT width, UINT height)
+{
+    UINT x, y;
+
+    InitOnceExecuteOnce(&srgb_gray_init_once, init_srgb_gray_thresholds, NULL, NULL);
+
+    for (y = 0; y < height; y++)
+    {
+        const BYTE *pixel = src;
+
+        for (x = 0; x < width; x++)
+        {
+            float gray = (pixel[red_offset] * 0.2126f + pixel[1] * 0.7152f + pixel[2 - red_offset] * 0.0722f) / 255.0f;
+
+            dst[x] = linear_gray_to_sRGB_byte_fast(gray);
+            pixel += pixel_size;
+        }
+        src += srcstride;
+        dst += dststride;
+    }
+}
+
 #if 0 /* FIXME: enable once needed */
 static inline float from_sRGB_component(float f)
 {
@@ -626,7 +753,6 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
             const BYTE *srcrow;
             const BYTE *srcpixel;
             BYTE *dstrow;
-            BYTE *dstpixel;
 
             srcstride = 3 * prc->Width;
             srcdatasize = srcstride * prc->Height;
@@ -641,13 +767,13 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
                 srcrow = srcdata;
                 dstrow = pbBuffer;
                 for (y=0; y<prc->Height; y++) {
+                    DWORD *dstpixel32 = (DWORD *)dstrow;
+
                     srcpixel=srcrow;
-                    dstpixel=dstrow;
                     for (x=0; x<prc->Width; x++) {
-                        *dstpixel++=*srcpixel++; /* blue */
-                        *dstpixel++=*srcpixel++; /* green */
-                        *dstpixel++=*srcpixel++; /* red */
-                        *dstpixel++=255; /* alpha */
+                        /* blue, green, red and an opaque alpha in a single store */
+                        dstpixel32[x] = srcpixel[0] | (srcpixel[1] << 8) | (srcpixel[2] << 16) | 0xff000000;
+                        srcpixel += 3;
                     }
                     srcrow += srcstride;
                     dstrow += cbStride;
@@ -718,8 +844,12 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
 
             /* set all alpha values to 255 */
             for (y=0; y<prc->Height; y++)
+            {
+                DWORD *pixel = (DWORD *)(pbBuffer + cbStride * y);
+
                 for (x=0; x<prc->Width; x++)
-                    pbBuffer[cbStride*y+4*x+3] = 0xff;
+                    pixel[x] |= 0xff000000;
+            }
         }
         return S_OK;
     case format_32bppBGRA:
@@ -730,22 +860,11 @@ static HRESULT copypixels_to_32bppBGRA(struct FormatConverter *This, const WICRe
         if (prc)
         {
             HRESULT res;
-            INT x, y;
 
             res = IWICBitmapSource_CopyPixels(This->source, prc, cbStride, cbBufferSize, pbBuffer);
             if (FAILED(res)) return res;
 
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 0 && alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * 255 / alpha;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * 255 / alpha;
-                    }
-                }
+            unpremultiply_alpha(pbBuffer, cbStride, prc->Width, prc->Height);
         }
         return S_OK;
     case format_48bppRGB:
@@ -880,8 +999,12 @@ static HRESULT copypixels_to_32bppRGBA(struct FormatConverter *This, const WICRe
 
             /* set all alpha values to 255 */
             for (y=0; y<prc->Height; y++)
+            {
+                DWORD *pixel = (DWORD *)(pbBuffer + cbStride * y);
+
                 for (x=0; x<prc->Width; x++)
-                    pbBuffer[cbStride*y+4*x+3] = 0xff;
+                    pixel[x] |= 0xff000000;
+            }
         }
         return S_OK;
 
@@ -966,21 +1089,7 @@ static HRESULT copypixels_to_32bppPBGRA(struct FormatConverter *This, const WICR
     default:
         hr = copypixels_to_32bppBGRA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * alpha / 255;
-                    }
-                }
-        }
+            premultiply_alpha(pbBuffer, cbStride, prc->Width, prc->Height);
         return hr;
     }
 }
@@ -999,21 +1108,7 @@ static HRESULT copypixels_to_32bppPRGBA(struct FormatConverter *This, const WICR
     default:
         hr = copypixels_to_32bppRGBA(This, prc, cbStride, cbBufferSize, pbBuffer, source_format);
         if (SUCCEEDED(hr) && prc)
-        {
-            INT x, y;
-
-            for (y=0; y<prc->Height; y++)
-                for (x=0; x<prc->Width; x++)
-                {
-                    BYTE alpha = pbBuffer[cbStride*y+4*x+3];
-                    if (alpha != 255)
-                    {
-                        pbBuffer[cbStride*y+4*x] = pbBuffer[cbStride*y+4*x] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+1] = pbBuffer[cbStride*y+4*x+1] * alpha / 255;
-                        pbBuffer[cbStride*y+4*x+2] = pbBuffer[cbStride*y+4*x+2] * alpha / 255;
-                    }
-                }
-        }
+            premultiply_alpha(pbBuffer, cbStride, prc->Width, prc->Height);
         return hr;
     }
 }
@@ -1364,33 +1459,42 @@ static HRESULT copypixels_to_8bppGray(struct FormatConverter *This, const WICRec
     if (!prc)
         return copypixels_to_24bppBGR(This, NULL, cbStride, cbBufferSize, pbBuffer, source_format);
 
-    srcstride = 3 * prc->Width;
-    srcdatasize = srcstride * prc->Height;
+    switch (source_format)
+    {
+    /* Read the common formats directly instead of going through 24bppBGR. */
+    case format_24bppBGR:
+    case format_24bppRGB:
+    case format_32bppBGR:
+    case format_32bppBGRA:
+    case format_32bppPBGRA:
+    case format_32bppRGBA:
+    {
+        UINT pixel_size = source_format == format_24bppBGR || source_format == format_24bppRGB ? 3 : 4;
+        UINT red_offset = source_format == format_24bppRGB || source_format == format_32bppRGBA ? 0 : 2;
 
-    srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
-    if (!srcdata) return E_OUTOFMEMORY;
+        srcstride = pixel_size * prc->Width;
+        srcdatasize = srcstride * prc->Height;
 
-    hr = copypixels_to_24bppBGR(This, prc, srcstride, srcdatasize, srcdata, source_format);
-    if (SUCCEEDED(hr))
-    {
-        INT x, y;
-        BYTE *src = srcdata, *dst = pbBuffer;
+        srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
+        if (!srcdata) return E_OUTOFMEMORY;
 
-        for (y = 0; y < prc->Height; y++)
-        {
-            BYTE *bgr = src;
+        hr = IWICBitmapSource_CopyPixels(This->source, prc, srcstride, srcdatasize, srcdata);
+        if (SUCCEEDED(hr))
+            convert_rows_to_8bppGray(srcdata, srcstride, pixel_size, red_offset,
+                                     pbBuffer, cbStride, prc->Width, prc->Height);
+        break;
+    }
+    default:
+        srcstride = 3 * prc->Width;
+        srcdatasize = srcstride * prc->Height;
 
-            for (x = 0; x < prc->Width; x++)
-            {
-                float gray = (bgr[2] * 0.2126f + bgr[1] * 0.7152f + bgr[0] * 0.0722f) / 255.0f;
+        srcdata = HeapAlloc(GetProcessHeap(), 0, srcdatasize);
+        if (!srcdata) return E_OUTOFMEMORY;
 
-                gray = to_sRGB_component(gray) * 255.0f;
-                dst[x] = (BYTE)floorf(gray + 0.51f);
-                bgr += 3;
-            }
-            src += srcstride;
-            dst += cbStride;
-        }
+        hr = copypixels_to_24bppBGR(This, prc, srcstride, srcdatasize, srcdata, source_format);
+        if (SUCCEEDED(hr))
+            convert_rows_to_8bppGray(srcdata, srcstride, 3, 2, pbBuffer, cbStride, prc->Width, prc->Height);
+        break;
     }
 
     HeapFree(GetProcessHeap(), 0, srcdata);
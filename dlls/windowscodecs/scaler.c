@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include <stdarg.h>
+#include <math.h>
 
 #define COBJMACROS
 
@@ -33,6 +34,21 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(wincodecs);
 
+/* Filter weights are stored as 2.14 fixed point values. */
+#define FILTER_SHIFT 14
+/* Extra precision kept between the vertical and the horizontal pass. */
+#define FILTER_INTERMEDIATE_SHIFT 7
+
+/* Precomputed contributions of the source pixels to each destination pixel
+ * along one axis. Every destination pixel uses "taps" consecutive source
+ * pixels starting at first[i]. */
+struct scaler_filter
+{
+    UINT taps;
+    UINT *first;
+    SHORT *weights;
+};
+
 typedef struct BitmapScaler {
     IWICBitmapScaler IWICBitmapScaler_iface;
     LONG ref;
@@ -44,6 +60,9 @@ typedef struct BitmapScaler {
     UINT bpp;
     void (*fn_get_required_source_rect)(struct BitmapScaler*,UINT,UINT,WICRect*);
     void (*fn_copy_scanline)(struct BitmapScaler*,UINT,UINT,UINT,BYTE**,UINT,UINT,BYTE*);
+    struct scaler_filter filter_x, filter_y;
+    INT *row_buffer;
+    BOOL straight_alpha; /* filter premultiplied colors of a format with unassociated alpha */
     CRITICAL_SECTION lock; /* must be held when initialized */
 } BitmapScaler;
 
@@ -108,6 +127,11 @@ static ULONG WINAPI BitmapScaler_Release(IWICBitmapScaler *iface)
         This->lock.DebugInfo->Spare[0] = 0;
         DeleteCriticalSection(&This->lock);
         if (This->source) IWICBitmapSource_Release(This->source);
+        HeapFree(GetProcessHeap(), 0, This->filter_x.first);
+        HeapFree(GetProcessHeap(), 0, This->filter_x.weights);
+        HeapFree(GetProcessHeap(), 0, This->filter_y.first);
+        HeapFree(GetProcessHeap(), 0, This->filter_y.weights);
+        HeapFree(GetProcessHeap(), 0, This->row_buffer);
         HeapFree(GetProcessHeap(), 0, This);
     }
 
@@ -205,6 +229,203 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+static double filter_triangle(double x)
+{
+    x = fabs(x);
+    return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+static double filter_cubic(double x)
+{
+    /* Catmull-Rom spline. */
+    x = fabs(x);
+    if (x < 1.0) return (1.5 * x - 2.5) * x * x + 1.0;
+    if (x < 2.0) return ((-0.5 * x + 2.5) * x - 4.0) * x + 2.0;
+    return 0.0;
+}
+
+static BOOL init_filter(struct scaler_filter *filter, WICBitmapInterpolationMode mode,
+    UINT src_size, UINT dst_size)
+{
+    double scale = (double)src_size / dst_size;
+    double filter_scale = max(scale, 1.0);
+    double support, center, sum, *values;
+    UINT i, j, taps;
+    int left, pos;
+
+    switch (mode)
+    {
+    case WICBitmapInterpolationModeLinear:
+        support = 1.0 * filter_scale;
+        break;
+    case WICBitmapInterpolationModeCubic:
+        support = 2.0 * filter_scale;
+        break;
+    default: /* WICBitmapInterpolationModeFant */
+        support = 0.5 * filter_scale + 0.5;
+        break;
+    }
+
+    taps = min((UINT)ceil(support * 2.0) + 1, src_size);
+
+    filter->taps = taps;
+    filter->first = HeapAlloc(GetProcessHeap(), 0, dst_size * sizeof(*filter->first));
+    filter->weights = HeapAlloc(GetProcessHeap(), 0, dst_size * taps * sizeof(*filter->weights));
+    values = HeapAlloc(GetProcessHeap(), 0, taps * sizeof(*values));
+    if (!filter->first || !filter->weights || !values)
+    {
+        HeapFree(GetProcessHeap(), 0, values);
+        return FALSE;
+    }
+
+    for (i = 0; i < dst_size; i++)
+    {
+        SHORT *weights = filter->weights + i * taps;
+        int total, largest;
+
+        center = (i + 0.5) * scale - 0.5;
+        left = (int)ceil(center - support);
+        filter->first[i] = min(max(left, 0), (int)(src_size - taps));
+
+        for (j = 0; j < taps; j++)
+            values[j] = 0.0;
+
+        /* Source pixels outside the image are clamped to the edge, fold
+         * their contributions onto the edge pixels. */
+        sum = 0.0;
+        for (pos = left; pos <= (int)floor(center + support); pos++)
+        {
+            double value, x = (pos - center) / filter_scale;
+            int clamped = min(max(pos, 0), (int)src_size - 1);
+
+            if (mode == WICBitmapInterpolationModeLinear)
+                value = filter_triangle(x);
+            else if (mode == WICBitmapInterpolationModeFant)
+                /* Area of the source pixel covered by the destination pixel. */
+                value = max(0.0, min(pos + 0.5, center + 0.5 * filter_scale)
+                        - max(pos - 0.5, center - 0.5 * filter_scale));
+            else
+                value = filter_cubic(x);
+
+            values[clamped - filter->first[i]] += value;
+            sum += value;
+        }
+
+        total = largest = 0;
+        for (j = 0; j < taps; j++)
+        {
+            weights[j] = (SHORT)floor(values[j] / sum * (1 << FILTER_SHIFT) + 0.5);
+            total += weights[j];
+            if (weights[j] > weights[largest]) largest = j;
+        }
+        /* Make sure the weights sum up to exactly one. */
+        weights[largest] += (1 << FILTER_SHIFT) - total;
+    }
+
+    HeapFree(GetProcessHeap(), 0, values);
+    return TRUE;
+}
+
+static void Filter_GetRequiredSourceRect(BitmapScaler *This,
+    UINT x, UINT y, WICRect *src_rect)
+{
+    src_rect->X = This->filter_x.first[x];
+    src_rect->Y = This->filter_y.first[y];
+    src_rect->Width = This->filter_x.taps;
+    src_rect->Height = This->filter_y.taps;
+}
+
+static void Filter_CopyScanline(BitmapScaler *This,
+    UINT dst_x, UINT dst_y, UINT dst_width,
+    BYTE **src_data, UINT src_data_x, UINT src_data_y, BYTE *pbBuffer)
+{
+    const struct scaler_filter *fx = &This->filter_x, *fy = &This->filter_y;
+    const SHORT *weights = fy->weights + dst_y * fy->taps;
+    UINT channels = This->bpp / 8;
+    UINT start = fx->first[dst_x];
+    UINT count = (fx->first[dst_x + dst_width - 1] + fx->taps - start) * channels;
+    UINT first_row = fy->first[dst_y] - src_data_y;
+    INT *row = This->row_buffer;
+    UINT i, j, c;
+
+    /* Vertical pass into an intermediate row covering the needed columns. */
+    for (i = 0; i < count; i++)
+        row[i] = 0;
+    for (j = 0; j < fy->taps; j++)
+    {
+        const BYTE *src = src_data[first_row + j] + (start - src_data_x) * channels;
+        INT weight = weights[j];
+
+        if (This->straight_alpha)
+        {
+            /* Premultiply, so that the color of transparent pixels doesn't
+             * bleed into their neighbours. */
+            for (i = 0; i < count; i += 4)
+            {
+                UINT alpha = src[i + 3];
+
+                row[i] += (src[i] * alpha + 127) / 255 * weight;
+                row[i + 1] += (src[i + 1] * alpha + 127) / 255 * weight;
+                row[i + 2] += (src[i + 2] * alpha + 127) / 255 * weight;
+                row[i + 3] += alpha * weight;
+            }
+            continue;
+        }
+
+        for (i = 0; i < count; i++)
+            row[i] += src[i] * weight;
+    }
+    for (i = 0; i < count; i++)
+        row[i] = (row[i] + (1 << (FILTER_INTERMEDIATE_SHIFT - 1))) >> FILTER_INTERMEDIATE_SHIFT;
+
+    /* Horizontal pass. */
+    for (i = 0; i < dst_width; i++)
+    {
+        const INT *src = row + (fx->first[dst_x + i] - start) * channels;
+
+        BYTE *dst = pbBuffer + i * channels;
+
+        weights = fx->weights + (dst_x + i) * fx->taps;
+        for (c = 0; c < channels; c++)
+        {
+            INT value = 1 << (FILTER_SHIFT * 2 - FILTER_INTERMEDIATE_SHIFT - 1);
+
+            for (j = 0; j < fx->taps; j++)
+                value += src[j * channels + c] * weights[j];
+            value >>= FILTER_SHIFT * 2 - FILTER_INTERMEDIATE_SHIFT;
+            dst[c] = min(max(value, 0), 255);
+        }
+
+        if (This->straight_alpha)
+        {
+            UINT alpha = dst[3];
+
+            for (c = 0; c < 3; c++)
+                dst[c] = alpha ? min((dst[c] * 255 + alpha / 2) / alpha, 255) : 0;
+        }
+    }
+}
+
+static BOOL is_filterable_format(const WICPixelFormatGUID *format)
+{
+    static const WICPixelFormatGUID *formats[] =
+    {
+        &GUID_WICPixelFormat8bppGray,
+        &GUID_WICPixelFormat24bppBGR,
+        &GUID_WICPixelFormat24bppRGB,
+        &GUID_WICPixelFormat32bppBGR,
+        &GUID_WICPixelFormat32bppBGRA,
+        &GUID_WICPixelFormat32bppPBGRA,
+        &GUID_WICPixelFormat32bppRGBA,
+        &GUID_WICPixelFormat32bppPRGBA,
+    };
+    UINT i;
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++)
+        if (IsEqualGUID(format, formats[i])) return TRUE;
+    return FALSE;
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -353,10 +574,40 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
     {
         switch (mode)
         {
+        case WICBitmapInterpolationModeLinear:
+        case WICBitmapInterpolationModeCubic:
+        case WICBitmapInterpolationModeFant:
+            if (is_filterable_format(&src_pixelformat))
+            {
+                if (!init_filter(&This->filter_x, mode, This->src_width, This->width) ||
+                    !init_filter(&This->filter_y, mode, This->src_height, This->height) ||
+                    !(This->row_buffer = HeapAlloc(GetProcessHeap(), 0,
+                        This->src_width * (This->bpp / 8) * sizeof(*This->row_buffer))))
+                {
+                    HeapFree(GetProcessHeap(), 0, This->filter_x.first);
+                    HeapFree(GetProcessHeap(), 0, This->filter_x.weights);
+                    HeapFree(GetProcessHeap(), 0, This->filter_y.first);
+                    HeapFree(GetProcessHeap(), 0, This->filter_y.weights);
+                    memset(&This->filter_x, 0, sizeof(This->filter_x));
+                    memset(&This->filter_y, 0, sizeof(This->filter_y));
+                    hr = E_OUTOFMEMORY;
+                    break;
+                }
+                IWICBitmapSource_AddRef(pISource);
+                This->source = pISource;
+                This->straight_alpha = IsEqualGUID(&src_pixelformat, &GUID_WICPixelFormat32bppBGRA) ||
+                        IsEqualGUID(&src_pixelformat, &GUID_WICPixelFormat32bppRGBA);
+                This->fn_get_required_source_rect = Filter_GetRequiredSourceRect;
+                This->fn_copy_scanline = Filter_CopyScanline;
+                break;
+            }
+            FIXME("unsupported pixel format %s for mode %i\n", debugstr_guid(&src_pixelformat), mode);
+            goto nearest;
         default:
             FIXME("unsupported mode %i\n", mode);
             /* fall-through */
         case WICBitmapInterpolationModeNearestNeighbor:
+        nearest:
             if ((This->bpp % 8) == 0)
             {
                 IWICBitmapSource_AddRef(pISource);
@@ -529,6 +780,10 @@ HRESULT BitmapScaler_Create(IWICBitmapScaler **scaler)
     This->src_height = 0;
     This->mode = 0;
     This->bpp = 0;
+    memset(&This->filter_x, 0, sizeof(This->filter_x));
+    memset(&This->filter_y, 0, sizeof(This->filter_y));
+    This->row_buffer = NULL;
+    This->straight_alpha = FALSE;
     InitializeCriticalSection(&This->lock);
     This->lock.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": BitmapScaler.lock");
 
@@ -1312,6 +1312,83 @@ static void test_bitmap_scaler(void)
     IWICBitmap_Release(bitmap);
 }
 
+static void test_bitmap_scaler_interpolation(void)
+{
+    static const BYTE src_data[] =
+    {
+        0x10,0x10,0x10, 0x20,0x20,0x20, 0x40,0x40,0x40, 0x40,0x40,0x40,
+        0x30,0x30,0x30, 0x40,0x40,0x40, 0x80,0x80,0x80, 0x80,0x80,0x80,
+    };
+    /* transparent red, opaque blue */
+    static const BYTE alpha_data[] = { 0x00,0x00,0xff,0x00, 0xff,0x00,0x00,0xff };
+    static const WICBitmapInterpolationMode modes[] =
+    {
+        WICBitmapInterpolationModeLinear,
+        WICBitmapInterpolationModeCubic,
+        WICBitmapInterpolationModeFant,
+    };
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    BYTE buf[4 * 2 * 3];
+    unsigned int i;
+    HRESULT hr;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 4, 2, &GUID_WICPixelFormat24bppBGR,
+        12, sizeof(src_data), (BYTE *)src_data, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#x.\n", hr);
+
+    for (i = 0; i < ARRAY_SIZE(modes); i++)
+    {
+        /* Scaling to the same size must not change the image. */
+        hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+        ok(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+        hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 4, 2, modes[i]);
+        ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#x.\n", hr);
+
+        memset(buf, 0xcc, sizeof(buf));
+        hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 12, sizeof(buf), buf);
+        ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+        ok(!memcmp(buf, src_data, sizeof(src_data)), "Mode %u: unexpected data.\n", modes[i]);
+
+        IWICBitmapScaler_Release(scaler);
+    }
+
+    /* Fant downscaling averages the covered source pixels. */
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 2, 1, WICBitmapInterpolationModeFant);
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#x.\n", hr);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 6, sizeof(buf), buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(buf[0] == 0x28 && buf[1] == 0x28 && buf[2] == 0x28, "Unexpected pixel %02x%02x%02x.\n",
+        buf[0], buf[1], buf[2]);
+    ok(buf[3] == 0x60 && buf[4] == 0x60 && buf[5] == 0x60, "Unexpected pixel %02x%02x%02x.\n",
+        buf[3], buf[4], buf[5]);
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+
+    /* The color of transparent pixels doesn't leak into the result. */
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, 2, 1, &GUID_WICPixelFormat32bppBGRA,
+        8, sizeof(alpha_data), (BYTE *)alpha_data, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#x.\n", hr);
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, 1, 1, WICBitmapInterpolationModeFant);
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#x.\n", hr);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 4, sizeof(buf), buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(buf[0] >= 0xfd && buf[1] <= 0x02 && buf[2] <= 0x02 && abs(buf[3] - 0x80) <= 1,
+        "Unexpected pixel %02x%02x%02x%02x.\n", buf[3], buf[2], buf[1], buf[0]);
+
+    IWICBitmapScaler_Release(scaler);
+    IWICBitmap_Release(bitmap);
+}
+
 static LONG obj_refcount(void *obj)
 {
     IUnknown_AddRef((IUnknown *)obj);
@@ -1482,6 +1559,7 @@ START_TEST(bitmap)
     test_CreateBitmapFromHBITMAP();
     test_clipper();
     test_bitmap_scaler();
+    test_bitmap_scaler_interpolation();
 
     IWICImagingFactory_Release(factory);
 
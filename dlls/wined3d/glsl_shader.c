@@ -50,6 +50,13 @@ WINE_DECLARE_DEBUG_CHANNEL(winediag);
 #define WINED3D_GLSL_SAMPLE_LOAD        0x08
 #define WINED3D_GLSL_SAMPLE_OFFSET      0x10
 
+#define WINED3D_GLSL_LINK_DUAL_SOURCE   0x01
+
+/* Bump this whenever the layout of the cache files or anything influencing
+ * the generated program binaries changes. */
+#define WINED3D_GLSL_CACHE_VERSION      1
+#define WINED3D_GLSL_CACHE_MAGIC        0x43534c47 /* "GLSC" */
+
 static const struct
 {
     unsigned int coord_size;
@@ -144,6 +151,31 @@ struct shader_glsl_priv
     struct wine_rb_tree ffp_fragment_shaders;
     BOOL ffp_proj_control;
     BOOL legacy_lighting;
+
+    struct glsl_program_cache
+    {
+        const char *path;
+        ULONG64 size, max_size;
+        ULONG64 driver_hash;
+        unsigned int hits, misses, stores;
+    } program_cache;
+};
+
+struct glsl_program_cache_key
+{
+    ULONG64 hash;
+    ULONG64 check;
+    DWORD source_size;
+};
+
+struct glsl_program_cache_header
+{
+    DWORD magic;
+    DWORD version;
+    ULONG64 check;
+    DWORD source_size;
+    DWORD binary_format;
+    DWORD binary_size;
 };
 
 struct glsl_vs_program
@@ -642,6 +674,309 @@ void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLuint pro
     print_glsl_info_log(gl_info, program, TRUE);
 }
 
+static ULONG64 glsl_program_cache_hash(ULONG64 hash, const void *data, size_t size)
+{
+    const BYTE *ptr = data;
+
+    /* 64-bit FNV-1a. */
+    while (size--)
+    {
+        hash ^= *ptr++;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static void shader_glsl_program_cache_get_filename(const struct glsl_program_cache *cache,
+        const struct glsl_program_cache_key *key, char *filename, unsigned int size)
+{
+    snprintf(filename, size, "%s\\%08x%08x.bin", cache->path,
+            (unsigned int)(key->hash >> 32), (unsigned int)key->hash);
+}
+
+static void shader_glsl_program_cache_init(struct glsl_program_cache *cache)
+{
+    char pattern[MAX_PATH];
+    WIN32_FIND_DATAA data;
+    HANDLE find;
+
+    memset(cache, 0, sizeof(*cache));
+    if (!wined3d_settings.shader_cache_path || !wined3d_settings.shader_cache_size)
+        return;
+
+    cache->path = wined3d_settings.shader_cache_path;
+    cache->max_size = (ULONG64)wined3d_settings.shader_cache_size * 1024 * 1024;
+    CreateDirectoryA(cache->path, NULL);
+
+    snprintf(pattern, sizeof(pattern), "%s\\*.bin", cache->path);
+    if ((find = FindFirstFileA(pattern, &data)) == INVALID_HANDLE_VALUE)
+        return;
+    do
+    {
+        cache->size += ((ULONG64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+
+    TRACE("Using shader cache %s, size 0x%s.\n", debugstr_a(cache->path), wine_dbgstr_longlong(cache->size));
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_program_cache_get_key(const struct wined3d_gl_info *gl_info,
+        struct glsl_program_cache *cache, GLuint program_id, DWORD link_flags, struct glsl_program_cache_key *key)
+{
+    static const GLenum driver_strings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+    GLint i, shader_count, source_size = 0, length;
+    GLuint shaders[8];
+    const char *str;
+    char *source;
+
+    if (!cache->driver_hash)
+    {
+        cache->driver_hash = 0xcbf29ce484222325ull;
+        for (i = 0; i < ARRAY_SIZE(driver_strings); ++i)
+        {
+            if ((str = (const char *)gl_info->gl_ops.gl.p_glGetString(driver_strings[i])))
+                cache->driver_hash = glsl_program_cache_hash(cache->driver_hash, str, strlen(str) + 1);
+        }
+    }
+
+    GL_EXTCALL(glGetAttachedShaders(program_id, ARRAY_SIZE(shaders), &shader_count, shaders));
+    for (i = 0; i < shader_count; ++i)
+    {
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        source_size = max(source_size, length);
+    }
+    if (!source_size || !(source = heap_alloc(source_size)))
+        return FALSE;
+
+    key->hash = glsl_program_cache_hash(cache->driver_hash, &link_flags, sizeof(link_flags));
+    key->check = glsl_program_cache_hash(0x84222325cbf29ce4ull, &link_flags, sizeof(link_flags));
+    key->source_size = 0;
+    for (i = 0; i < shader_count; ++i)
+    {
+        GL_EXTCALL(glGetShaderSource(shaders[i], source_size, &length, source));
+        key->hash = glsl_program_cache_hash(key->hash, source, length);
+        key->check = glsl_program_cache_hash(key->check, source, length);
+        key->source_size += length;
+    }
+    checkGLcall("get program cache key");
+    heap_free(source);
+
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_program_cache_load(const struct wined3d_gl_info *gl_info,
+        struct glsl_program_cache *cache, GLuint program_id, const struct glsl_program_cache_key *key)
+{
+    struct glsl_program_cache_header header;
+    char filename[MAX_PATH];
+    DWORD size, file_size;
+    void *binary = NULL;
+    BOOL ret = FALSE;
+    FILETIME now;
+    GLint status;
+    HANDLE file;
+
+    shader_glsl_program_cache_get_filename(cache, key, filename, sizeof(filename));
+    file = CreateFileA(filename, GENERIC_READ | FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ,
+            NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    /* The file may have been truncated or written by something else; never
+     * trust binary_size beyond what is actually on disk. */
+    file_size = GetFileSize(file, NULL);
+    if (file_size == INVALID_FILE_SIZE || file_size < sizeof(header)
+            || !ReadFile(file, &header, sizeof(header), &size, NULL) || size != sizeof(header)
+            || header.magic != WINED3D_GLSL_CACHE_MAGIC || header.version != WINED3D_GLSL_CACHE_VERSION
+            || header.check != key->check || header.source_size != key->source_size
+            || !header.binary_size || header.binary_size != file_size - sizeof(header))
+    {
+        WARN("Ignoring stale or mismatching cache file %s.\n", debugstr_a(filename));
+        goto done;
+    }
+
+    if (!(binary = heap_alloc(header.binary_size)) || !ReadFile(file, binary, header.binary_size, &size, NULL)
+            || size != header.binary_size)
+        goto done;
+
+    GL_EXTCALL(glProgramBinary(program_id, header.binary_format, binary, header.binary_size));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    checkGLcall("glProgramBinary");
+    if (!(ret = !!status))
+        WARN("Failed to load program binary from %s, format %#x.\n", debugstr_a(filename), header.binary_format);
+
+done:
+    heap_free(binary);
+    if (ret)
+    {
+        /* Entries are evicted in order of last write time; refresh it on use. */
+        GetSystemTimeAsFileTime(&now);
+        SetFileTime(file, NULL, NULL, &now);
+    }
+    CloseHandle(file);
+    /* Binaries rejected by the driver are replaced after relinking. */
+    if (!ret && DeleteFileA(filename) && file_size != INVALID_FILE_SIZE)
+        cache->size -= min(cache->size, file_size);
+    return ret;
+}
+
+struct glsl_program_cache_entry
+{
+    char name[MAX_PATH];
+    ULONG64 time;
+    ULONG64 size;
+};
+
+static int glsl_program_cache_entry_compare(const void *a, const void *b)
+{
+    const struct glsl_program_cache_entry *e1 = a, *e2 = b;
+
+    return e1->time < e2->time ? -1 : e1->time > e2->time;
+}
+
+/* Removes the least recently used cache files until "needed" more bytes fit
+ * in the cache. Evicting down to three quarters of the limit avoids rescanning
+ * the directory on every subsequent store. */
+static BOOL shader_glsl_program_cache_evict(struct glsl_program_cache *cache, ULONG64 needed)
+{
+    struct glsl_program_cache_entry *entries = NULL, *new_entries;
+    unsigned int count = 0, capacity = 0, i;
+    ULONG64 target, total = 0;
+    char path[MAX_PATH];
+    WIN32_FIND_DATAA data;
+    HANDLE find;
+
+    if (needed > cache->max_size)
+        return FALSE;
+    target = cache->max_size - cache->max_size / 4;
+    if (needed > target)
+        target = cache->max_size;
+
+    snprintf(path, sizeof(path), "%s\\*.bin", cache->path);
+    if ((find = FindFirstFileA(path, &data)) != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (count == capacity)
+            {
+                capacity = max(capacity * 2, 64);
+                if (!(new_entries = heap_realloc(entries, capacity * sizeof(*entries))))
+                    break;
+                entries = new_entries;
+            }
+            lstrcpynA(entries[count].name, data.cFileName, sizeof(entries[count].name));
+            entries[count].time = ((ULONG64)data.ftLastWriteTime.dwHighDateTime << 32)
+                    | data.ftLastWriteTime.dwLowDateTime;
+            entries[count].size = ((ULONG64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+            total += entries[count++].size;
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+
+    /* Other processes may share the cache directory, so resynchronise. */
+    cache->size = total;
+    if (count)
+        qsort(entries, count, sizeof(*entries), glsl_program_cache_entry_compare);
+    for (i = 0; i < count && cache->size + needed > target; ++i)
+    {
+        snprintf(path, sizeof(path), "%s\\%s", cache->path, entries[i].name);
+        if (DeleteFileA(path))
+            cache->size -= entries[i].size;
+    }
+    heap_free(entries);
+
+    TRACE("Evicted %u cache files, size now 0x%s.\n", i, wine_dbgstr_longlong(cache->size));
+    return cache->size + needed <= cache->max_size;
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_program_cache_store(const struct wined3d_gl_info *gl_info,
+        struct glsl_program_cache *cache, GLuint program_id, const struct glsl_program_cache_key *key)
+{
+    struct glsl_program_cache_header header;
+    char filename[MAX_PATH];
+    GLint status, length;
+    GLenum format;
+    void *binary;
+    HANDLE file;
+    DWORD size;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (!status || length <= 0)
+        return;
+
+    if (cache->size + sizeof(header) + length > cache->max_size
+            && !shader_glsl_program_cache_evict(cache, sizeof(header) + length))
+    {
+        TRACE("Shader cache is full, not storing program %u.\n", program_id);
+        return;
+    }
+
+    if (!(binary = heap_alloc(length)))
+        return;
+    GL_EXTCALL(glGetProgramBinary(program_id, length, &length, &format, binary));
+    checkGLcall("glGetProgramBinary");
+
+    header.magic = WINED3D_GLSL_CACHE_MAGIC;
+    header.version = WINED3D_GLSL_CACHE_VERSION;
+    header.check = key->check;
+    header.source_size = key->source_size;
+    header.binary_format = format;
+    header.binary_size = length;
+
+    shader_glsl_program_cache_get_filename(cache, key, filename, sizeof(filename));
+    file = CreateFileA(filename, GENERIC_WRITE, 0, NULL, CREATE_NEW, 0, NULL);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        if (WriteFile(file, &header, sizeof(header), &size, NULL) && size == sizeof(header)
+                && WriteFile(file, binary, length, &size, NULL) && size == length)
+        {
+            cache->size += sizeof(header) + length;
+            ++cache->stores;
+            CloseHandle(file);
+        }
+        else
+        {
+            WARN("Failed to write cache file %s.\n", debugstr_a(filename));
+            CloseHandle(file);
+            DeleteFileA(filename);
+        }
+    }
+    heap_free(binary);
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_link_program(const struct wined3d_gl_info *gl_info,
+        struct shader_glsl_priv *priv, GLuint program_id, DWORD link_flags)
+{
+    struct glsl_program_cache *cache = &priv->program_cache;
+    struct glsl_program_cache_key key;
+    BOOL use_cache;
+
+    if ((use_cache = cache->path && gl_info->supported[ARB_GET_PROGRAM_BINARY]
+            && shader_glsl_program_cache_get_key(gl_info, cache, program_id, link_flags, &key)))
+    {
+        if (shader_glsl_program_cache_load(gl_info, cache, program_id, &key))
+        {
+            TRACE("Loaded GLSL shader program %u from the shader cache.\n", program_id);
+            ++cache->hits;
+            return;
+        }
+        ++cache->misses;
+        GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+
+    TRACE("Linking GLSL shader program %u.\n", program_id);
+    GL_EXTCALL(glLinkProgram(program_id));
+    shader_glsl_validate_link(gl_info, program_id);
+
+    if (use_cache)
+        shader_glsl_program_cache_store(gl_info, cache, program_id, &key);
+}
+
 static BOOL shader_glsl_use_layout_qualifier(const struct wined3d_gl_info *gl_info)
 {
     /* Layout qualifiers were introduced in GLSL 1.40. The Nvidia Legacy GPU
@@ -10115,9 +10450,7 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
 
     list_add_head(&shader->linked_programs, &entry->cs.shader_entry);
 
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    shader_glsl_link_program(gl_info, priv, program_id, 0);
 
     GL_EXTCALL(glUseProgram(program_id));
     checkGLcall("glUseProgram");
@@ -10448,9 +10781,8 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
     }
 
     /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    shader_glsl_link_program(gl_info, priv, program_id,
+            state->blend_state && state->blend_state->dual_source ? WINED3D_GLSL_LINK_DUAL_SOURCE : 0);
 
     shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
             vshader ? vshader->limits->constant_float : 0);
@@ -11047,6 +11379,7 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
     fragment_pipe->get_caps(device->adapter, &fragment_caps);
     priv->ffp_proj_control = fragment_caps.wined3d_caps & WINED3D_FRAGMENT_CAP_PROJ_CONTROL;
     priv->legacy_lighting = device->wined3d->flags & WINED3D_LEGACY_FFP_LIGHTING;
+    shader_glsl_program_cache_init(&priv->program_cache);
 
     device->vertex_priv = vertex_priv;
     device->fragment_priv = fragment_priv;
@@ -11070,6 +11403,10 @@ static void shader_glsl_free(struct wined3d_device *device, struct wined3d_conte
 {
     struct shader_glsl_priv *priv = device->shader_priv;
 
+    if (priv->program_cache.path)
+        TRACE("Shader cache statistics: %u hits, %u misses, %u programs stored.\n",
+                priv->program_cache.hits, priv->program_cache.misses, priv->program_cache.stores);
+
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
@@ -682,21 +682,21 @@ static void convert_l4a4_unorm(const BYTE *src, BYTE *dst, UINT src_row_pitch, U
      * with A4L4 internal, but A8L8 format+type
      */
     unsigned int x, y, z;
-    const unsigned char *Source;
-    unsigned char *Dest;
+    const BYTE *source;
+    WORD *dest;
 
     for (z = 0; z < depth; z++)
     {
         for (y = 0; y < height; y++)
         {
-            Source = src + z * src_slice_pitch + y * src_row_pitch;
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
-            for (x = 0; x < width; x++ )
+            source = src + z * src_slice_pitch + y * src_row_pitch;
+            dest = (WORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
+            /* Write whole texels at a time; this keeps the loop free of
+             * byte stores and lets the compiler vectorise it. */
+            for (x = 0; x < width; ++x)
             {
-                unsigned char color = (*Source++);
-                /* A */ Dest[1] = (color & 0xf0u) << 0;
-                /* L */ Dest[0] = (color & 0x0fu) << 4;
-                Dest += 2;
+                /* A */ dest[x] = (source[x] & 0xf0u) << 8
+                /* L */         | (source[x] & 0x0fu) << 4;
             }
         }
     }
@@ -823,22 +823,23 @@ static void convert_r8g8_snorm(const BYTE *src, BYTE *dst, UINT src_row_pitch, U
         UINT dst_row_pitch, UINT dst_slice_pitch, UINT width, UINT height, UINT depth)
 {
     unsigned int x, y, z;
-    const short *Source;
-    unsigned char *Dest;
+    const WORD *source;
+    BYTE *dest;
 
     for (z = 0; z < depth; z++)
     {
         for (y = 0; y < height; y++)
         {
-            Source = (const short *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
-            for (x = 0; x < width; x++ )
+            source = (const WORD *)(src + z * src_slice_pitch + y * src_row_pitch);
+            dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
+            /* Adding 128 to a signed byte is the same as flipping its top bit. */
+            for (x = 0; x < width; ++x)
             {
-                const short color = (*Source++);
-                /* B */ Dest[0] = 0xff;
-                /* G */ Dest[1] = (color >> 8) + 128; /* V */
-                /* R */ Dest[2] = (color & 0xff) + 128;      /* U */
-                Dest += 3;
+                WORD color = source[x] ^ 0x8080u;
+
+                /* B */ dest[x * 3 + 0] = 0xff;
+                /* G */ dest[x * 3 + 1] = color >> 8;   /* V */
+                /* R */ dest[x * 3 + 2] = color & 0xff; /* U */
             }
         }
     }
@@ -848,8 +849,8 @@ static void convert_r8g8_snorm_l8x8_unorm(const BYTE *src, BYTE *dst, UINT src_r
         UINT dst_row_pitch, UINT dst_slice_pitch, UINT width, UINT height, UINT depth)
 {
     unsigned int x, y, z;
-    const DWORD *Source;
-    unsigned char *Dest;
+    const DWORD *source;
+    DWORD *dest;
 
     /* Doesn't work correctly with the fixed function pipeline, but can work in
      * shaders if the shader is adjusted. (There's no use for this format in gl's
@@ -859,15 +860,15 @@ static void convert_r8g8_snorm_l8x8_unorm(const BYTE *src, BYTE *dst, UINT src_r
     {
         for (y = 0; y < height; y++)
         {
-            Source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
-            for (x = 0; x < width; x++ )
+            source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
+            dest = (DWORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
+            for (x = 0; x < width; ++x)
             {
-                LONG color = (*Source++);
-                /* B */ Dest[0] = ((color >> 16) & 0xff);       /* L */
-                /* G */ Dest[1] = ((color >> 8 ) & 0xff) + 128; /* V */
-                /* R */ Dest[2] = (color         & 0xff) + 128; /* U */
-                Dest += 4;
+                DWORD color = source[x] ^ 0x00008080u;
+
+                /* B */ dest[x] = ((color >> 16) & 0xff)       /* L */
+                /* G */         | (color & 0xff00)             /* V */
+                /* R */         | ((color & 0xff) << 16);      /* U */
             }
         }
     }
@@ -877,8 +878,8 @@ static void convert_r8g8_snorm_l8x8_unorm_nv(const BYTE *src, BYTE *dst, UINT sr
         UINT dst_row_pitch, UINT dst_slice_pitch, UINT width, UINT height, UINT depth)
 {
     unsigned int x, y, z;
-    const DWORD *Source;
-    unsigned char *Dest;
+    const DWORD *source;
+    DWORD *dest;
 
     /* This implementation works with the fixed function pipeline and shaders
      * without further modification after converting the surface.
@@ -887,16 +888,12 @@ static void convert_r8g8_snorm_l8x8_unorm_nv(const BYTE *src, BYTE *dst, UINT sr
     {
         for (y = 0; y < height; y++)
         {
-            Source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
-            for (x = 0; x < width; x++ )
+            source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
+            dest = (DWORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
+            for (x = 0; x < width; ++x)
             {
-                LONG color = (*Source++);
-                /* L */ Dest[2] = ((color >> 16) & 0xff);   /* L */
-                /* V */ Dest[1] = ((color >> 8 ) & 0xff);   /* V */
-                /* U */ Dest[0] = (color         & 0xff);   /* U */
-                /* I */ Dest[3] = 255;                      /* X */
-                Dest += 4;
+                /* U, V and L are kept in place, X is set to 255. */
+                dest[x] = source[x] | 0xff000000u;
             }
         }
     }
@@ -906,23 +903,22 @@ static void convert_r8g8b8a8_snorm(const BYTE *src, BYTE *dst, UINT src_row_pitc
         UINT dst_row_pitch, UINT dst_slice_pitch, UINT width, UINT height, UINT depth)
 {
     unsigned int x, y, z;
-    const DWORD *Source;
-    unsigned char *Dest;
+    const DWORD *source;
+    DWORD *dest;
 
     for (z = 0; z < depth; z++)
     {
         for (y = 0; y < height; y++)
         {
-            Source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = dst + z * dst_slice_pitch + y * dst_row_pitch;
-            for (x = 0; x < width; x++ )
+            source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
+            dest = (DWORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
+            for (x = 0; x < width; ++x)
             {
-                LONG color = (*Source++);
-                /* B */ Dest[0] = ((color >> 16) & 0xff) + 128; /* W */
-                /* G */ Dest[1] = ((color >> 8 ) & 0xff) + 128; /* V */
-                /* R */ Dest[2] = (color         & 0xff) + 128; /* U */
-                /* A */ Dest[3] = ((color >> 24) & 0xff) + 128; /* Q */
-                Dest += 4;
+                DWORD color = source[x] ^ 0x80808080u;
+
+                /* B */ dest[x] = ((color >> 16) & 0xff)   /* W */
+                /* G */         | (color & 0xff00ff00u)    /* V, Q */
+                /* R */         | ((color & 0xff) << 16);  /* U */
             }
         }
     }
@@ -932,22 +928,22 @@ static void convert_r16g16_snorm(const BYTE *src, BYTE *dst, UINT src_row_pitch,
         UINT dst_row_pitch, UINT dst_slice_pitch, UINT width, UINT height, UINT depth)
 {
     unsigned int x, y, z;
-    const DWORD *Source;
-    unsigned short *Dest;
+    const DWORD *source;
+    WORD *dest;
 
     for (z = 0; z < depth; z++)
     {
         for (y = 0; y < height; y++)
         {
-            Source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
-            Dest = (unsigned short *) (dst + z * dst_slice_pitch + y * dst_row_pitch);
-            for (x = 0; x < width; x++ )
+            source = (const DWORD *)(src + z * src_slice_pitch + y * src_row_pitch);
+            dest = (WORD *)(dst + z * dst_slice_pitch + y * dst_row_pitch);
+            for (x = 0; x < width; ++x)
             {
-                const DWORD color = (*Source++);
-                /* B */ Dest[0] = 0xffff;
-                /* G */ Dest[1] = (color >> 16) + 32768; /* V */
-                /* R */ Dest[2] = (color & 0xffff) + 32768; /* U */
-                Dest += 3;
+                DWORD color = source[x] ^ 0x80008000u;
+
+                /* B */ dest[x * 3 + 0] = 0xffff;
+                /* G */ dest[x * 3 + 1] = color >> 16;     /* V */
+                /* R */ dest[x * 3 + 2] = color & 0xffff;  /* U */
             }
         }
     }
@@ -1096,10 +1092,9 @@ static void convert_b5g6r5_unorm_b5g5r5a1_unorm_color_key(const BYTE *src, unsig
         for (x = 0; x < width; ++x)
         {
             WORD src_color = src_row[x];
-            if (!color_in_range(color_key, src_color))
-                dst_row[x] = 0x8000u | ((src_color & 0xffc0u) >> 1) | (src_color & 0x1fu);
-            else
-                dst_row[x] = ((src_color & 0xffc0u) >> 1) | (src_color & 0x1fu);
+
+            dst_row[x] = (color_in_range(color_key, src_color) ? 0 : 0x8000u)
+                    | ((src_color & 0xffc0u) >> 1) | (src_color & 0x1fu);
         }
     }
 }
@@ -1119,10 +1114,8 @@ static void convert_b5g5r5x1_unorm_b5g5r5a1_unorm_color_key(const BYTE *src, uns
         for (x = 0; x < width; ++x)
         {
             WORD src_color = src_row[x];
-            if (color_in_range(color_key, src_color))
-                dst_row[x] = src_color & ~0x8000;
-            else
-                dst_row[x] = src_color | 0x8000;
+
+            dst_row[x] = (src_color & ~0x8000u) | (color_in_range(color_key, src_color) ? 0 : 0x8000u);
         }
     }
 }
@@ -1163,10 +1156,8 @@ static void convert_b8g8r8x8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, uns
         for (x = 0; x < width; ++x)
         {
             DWORD src_color = src_row[x];
-            if (color_in_range(color_key, src_color))
-                dst_row[x] = src_color & ~0xff000000;
-            else
-                dst_row[x] = src_color | 0xff000000;
+
+            dst_row[x] = (src_color & ~0xff000000u) | (color_in_range(color_key, src_color) ? 0 : 0xff000000u);
         }
     }
 }
@@ -1186,9 +1177,8 @@ static void convert_b8g8r8a8_unorm_b8g8r8a8_unorm_color_key(const BYTE *src, uns
         for (x = 0; x < width; ++x)
         {
             DWORD src_color = src_row[x];
-            if (color_in_range(color_key, src_color))
-                src_color &= ~0xff000000;
-            dst_row[x] = src_color;
+
+            dst_row[x] = src_color & (color_in_range(color_key, src_color) ? ~0xff000000u : ~0u);
         }
     }
 }
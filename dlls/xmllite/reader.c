@@ -363,6 +363,21 @@ static HRESULT reader_strvaldup(xmlreader *reader, const strval *src, strval *de
     return S_OK;
 }
 
+/* makes a null-terminated copy of a value that points to input buffer */
+static const WCHAR *reader_strval_terminate(xmlreader *reader, strval *v)
+{
+    if (!v->str)
+    {
+        WCHAR *str = reader_alloc(reader, (v->len+1)*sizeof(WCHAR));
+        if (!str) return NULL;
+        memcpy(str, reader_get_ptr2(reader, v->start), v->len*sizeof(WCHAR));
+        str[v->len] = 0;
+        v->str = str;
+    }
+
+    return v->str;
+}
+
 /* reader input memory allocation functions */
 static inline void *readerinput_alloc(xmlreaderinput *input, size_t len)
 {
@@ -419,29 +434,18 @@ static void reader_clear_attrs(xmlreader *reader)
 }
 
 /* attribute data holds pointers to buffer data, so buffer shrink is not possible
-   while we are on a node with attributes */
+   while we are on a node with attributes. Null-terminated copies of local name
+   and value are only made when requested, with reader_strval_terminate(). */
 static HRESULT reader_add_attr(xmlreader *reader, strval *prefix, strval *localname, strval *qname,
     strval *value, const struct reader_position *position, unsigned int flags)
 {
     struct attribute *attr;
-    HRESULT hr;
 
     attr = reader_alloc(reader, sizeof(*attr));
     if (!attr) return E_OUTOFMEMORY;
 
-    hr = reader_strvaldup(reader, localname, &attr->localname);
-    if (hr == S_OK)
-    {
-        hr = reader_strvaldup(reader, value, &attr->value);
-        if (hr != S_OK)
-            reader_free_strvalued(reader, &attr->value);
-    }
-    if (hr != S_OK)
-    {
-        reader_free(reader, attr);
-        return hr;
-    }
-
+    attr->localname = *localname;
+    attr->value = *value;
     if (prefix)
         attr->prefix = *prefix;
     else
@@ -864,8 +868,9 @@ static void readerinput_grow(xmlreaderinput *readerinput, int length)
     encoded_buffer *buffer = &readerinput->buffer->utf16;
 
     length *= sizeof(WCHAR);
-    /* grow if needed, plus 4 bytes to be sure null terminator will fit in */
-    if (buffer->allocated < buffer->written + length + 4)
+    /* grow if needed, plus 8 bytes to be sure null terminator will fit in,
+       and a whole word can be read at terminator position, see reader_scan_run() */
+    if (buffer->allocated < buffer->written + length + 8)
     {
         int grown_size = max(2*buffer->allocated, buffer->allocated + length);
         buffer->data = readerinput_realloc(readerinput, buffer->data, grown_size);
@@ -984,13 +989,39 @@ static void readerinput_shrinkraw(xmlreaderinput *readerinput, int len)
     buffer->cur = 0;
 }
 
+/* Text is scanned four WCHARs at a time, packed in a 64-bit word. Returns non-zero
+   if any of the characters in a word is equal to 'ch'. */
+#define WCHAR_X4(ch) (0x0001000100010001ull * (WCHAR)(ch))
+
+static inline UINT64 wchar_x4_eq(UINT64 word, WCHAR ch)
+{
+    UINT64 x = word ^ WCHAR_X4(ch);
+    return (x - WCHAR_X4(1)) & ~x & WCHAR_X4(0x8000);
+}
+
 static void fixup_buffer_cr(encoded_buffer *buffer, int off)
 {
+    const WCHAR *end = (const WCHAR *)(buffer->data + buffer->written);
     BOOL prev_cr = buffer->prev_cr;
     const WCHAR *src;
     WCHAR *dest;
+    UINT64 word;
 
     src = dest = (WCHAR*)buffer->data + off;
+
+    /* nothing to do up to the first carriage return */
+    if (!prev_cr)
+    {
+        while (src + 4 <= end)
+        {
+            memcpy(&word, src, sizeof(word));
+            if (wchar_x4_eq(word, '\r')) break;
+            src += 4;
+        }
+        while (src < end && *src != '\r') src++;
+        dest = (WCHAR *)src;
+    }
+
     while ((const char*)src < buffer->data + buffer->written)
     {
         if (*src == '\r')
@@ -1039,10 +1070,9 @@ static void readerinput_switchencoding(xmlreaderinput *readerinput, xml_encoding
     }
     else
     {
-        dest_len = MultiByteToWideChar(cp, 0, src->data + src->cur, len, NULL, 0);
-        readerinput_grow(readerinput, dest_len);
+        readerinput_grow(readerinput, len);
         ptr = (WCHAR*)dest->data;
-        MultiByteToWideChar(cp, 0, src->data + src->cur, len, ptr, dest_len);
+        dest_len = MultiByteToWideChar(cp, 0, src->data + src->cur, len, ptr, len);
         ptr[dest_len] = 0;
         dest->written += dest_len*sizeof(WCHAR);
     }
@@ -1055,6 +1085,9 @@ static void reader_shrink(xmlreader *reader)
 {
     encoded_buffer *buffer = &reader->input->buffer->utf16;
 
+    /* attribute strings are offsets in buffer, see reader_add_attr() */
+    if (!list_empty(&reader->attrs)) return;
+
     /* avoid to move too often using threshold shrink length */
     if (buffer->cur*sizeof(WCHAR) > buffer->written / 2)
     {
@@ -1091,10 +1124,10 @@ static HRESULT reader_more(xmlreader *reader)
     }
     else
     {
-        dest_len = MultiByteToWideChar(cp, 0, src->data + src->cur, len, NULL, 0);
-        readerinput_grow(readerinput, dest_len);
+        /* a byte never converts to more than one WCHAR, so it's done in a single pass */
+        readerinput_grow(readerinput, len);
         ptr = (WCHAR*)(dest->data + dest->written);
-        MultiByteToWideChar(cp, 0, src->data + src->cur, len, ptr, dest_len);
+        dest_len = MultiByteToWideChar(cp, 0, src->data + src->cur, len, ptr, len);
         ptr[dest_len] = 0;
         dest->written += dest_len*sizeof(WCHAR);
         /* get rid of processed data */
@@ -1162,6 +1195,35 @@ static void reader_skipn(xmlreader *reader, int n)
     }
 }
 
+/* moves cursor over n WCHARs that are known to contain no line breaks */
+static inline void reader_skip_run(xmlreader *reader, UINT n)
+{
+    reader->input->buffer->utf16.cur += n;
+    reader->position.line_position += n;
+}
+
+/* Returns length of a run of characters that need no special handling, the run ends
+   on null terminator, line feed or any of given delimiters, unused ones are set to 0. */
+static UINT reader_scan_run(const WCHAR *ptr, WCHAR d1, WCHAR d2, WCHAR d3)
+{
+    const WCHAR *start = ptr;
+    UINT64 word;
+
+    for (;;)
+    {
+        memcpy(&word, ptr, sizeof(word));
+        if (wchar_x4_eq(word, 0) | wchar_x4_eq(word, '\n') | wchar_x4_eq(word, d1) |
+                wchar_x4_eq(word, d2) | wchar_x4_eq(word, d3))
+            break;
+        ptr += 4;
+    }
+
+    while (*ptr && *ptr != '\n' && *ptr != d1 && *ptr != d2 && *ptr != d3)
+        ptr++;
+
+    return ptr - start;
+}
+
 static inline BOOL is_wchar_space(WCHAR ch)
 {
     return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
@@ -1448,6 +1510,15 @@ static HRESULT reader_parse_comment(xmlreader *reader)
        read more from stream */
     while (*ptr)
     {
+        UINT len;
+
+        if ((len = reader_scan_run(ptr, '-', 0, 0)))
+        {
+            reader_skip_run(reader, len);
+            ptr += len;
+            continue;
+        }
+
         if (ptr[0] == '-')
         {
             if (ptr[1] == '-')
@@ -1584,7 +1655,10 @@ static HRESULT reader_parse_name(xmlreader *reader, strval *name)
 
     while (is_namechar(*ptr))
     {
-        reader_skipn(reader, 1);
+        UINT len = 1;
+
+        while (is_namechar(ptr[len])) len++;
+        reader_skip_run(reader, len);
         ptr = reader_get_ptr(reader);
     }
 
@@ -1944,7 +2018,10 @@ static HRESULT reader_parse_local(xmlreader *reader, strval *local, BOOL check_f
 
     while (is_ncnamechar(*ptr))
     {
-        reader_skipn(reader, 1);
+        UINT len = 1;
+
+        while (is_ncnamechar(ptr[len])) len++;
+        reader_skip_run(reader, len);
         ptr = reader_get_ptr(reader);
     }
 
@@ -2001,7 +2078,10 @@ static HRESULT reader_parse_qname(xmlreader *reader, strval *prefix, strval *loc
         /* skip prefix part */
         while (is_ncnamechar(*ptr))
         {
-            reader_skipn(reader, 1);
+            UINT len = 1;
+
+            while (is_ncnamechar(ptr[len])) len++;
+            reader_skip_run(reader, len);
             ptr = reader_get_ptr(reader);
         }
 
@@ -2198,6 +2278,18 @@ static HRESULT reader_parse_attvalue(xmlreader *reader, strval *value)
     start = reader_get_cur(reader);
     while (*ptr)
     {
+        UINT len, i;
+
+        if ((len = reader_scan_run(ptr, quote, '<', '&')))
+        {
+            /* replace all whitespace chars with ' ', line feeds are handled below */
+            for (i = 0; i < len; i++)
+                if (ptr[i] == '\t') ptr[i] = ' ';
+            reader_skip_run(reader, len);
+            ptr = reader_get_ptr(reader);
+            continue;
+        }
+
         if (*ptr == '<') return WC_E_LESSTHAN;
 
         if (*ptr == quote)
@@ -2420,6 +2512,15 @@ static HRESULT reader_parse_cdata(xmlreader *reader)
 
     while (*ptr)
     {
+        UINT len;
+
+        if ((len = reader_scan_run(ptr, ']', 0, 0)))
+        {
+            reader_skip_run(reader, len);
+            ptr = reader_get_ptr(reader);
+            continue;
+        }
+
         if (*ptr == ']' && *(ptr+1) == ']' && *(ptr+2) == '>')
         {
             strval value;
@@ -2474,6 +2575,17 @@ static HRESULT reader_parse_chardata(xmlreader *reader)
     while (*ptr)
     {
         static const WCHAR ampW[] = {'&',0};
+        UINT len, i;
+
+        /* skip over plain text at once */
+        if ((len = reader_scan_run(ptr, '<', '&', ']')))
+        {
+            for (i = 0; reader->nodetype == XmlNodeType_Whitespace && i < len; i++)
+                if (!is_wchar_space(ptr[i])) reader->nodetype = XmlNodeType_Text;
+            reader_skip_run(reader, len);
+            ptr = reader_get_ptr(reader);
+            continue;
+        }
 
         /* CDATA closing sequence ']]>' is not allowed */
         if (ptr[0] == ']' && ptr[1] == ']' && ptr[2] == '>')
@@ -3057,7 +3169,7 @@ static void reader_get_attribute_local_name(xmlreader *reader, struct attribute
     }
     else
     {
-        *name = attr->localname.str;
+        *name = reader_get_strptr(reader, &attr->localname);
         *len = attr->localname.len;
     }
 }
@@ -3092,7 +3204,7 @@ static HRESULT WINAPI xmlreader_MoveToAttributeByName(IXmlReader* iface,
         reader_get_attribute_ns_uri(This, attr, &uri, &uri_len);
 
         if (name_len == target_name_len && uri_len == target_uri_len &&
-                !wcscmp(name, local_name) && !wcscmp(uri, namespace_uri))
+                !memcmp(name, local_name, name_len * sizeof(WCHAR)) && !wcscmp(uri, namespace_uri))
         {
             reader_set_current_attribute(This, attr);
             return S_OK;
@@ -3180,8 +3292,9 @@ static HRESULT WINAPI xmlreader_GetQualifiedName(IXmlReader* iface, LPCWSTR *nam
         }
         else
         {
-            *name = attribute->localname.str;
+            *name = reader_strval_terminate(This, &attribute->localname);
             *len = attribute->localname.len;
+            if (!*name) return E_OUTOFMEMORY;
         }
         break;
     default:
@@ -3284,6 +3397,8 @@ static HRESULT WINAPI xmlreader_GetLocalName(IXmlReader* iface, LPCWSTR *name, U
         *len = element->localname.len;
         break;
     case XmlNodeType_Attribute:
+        if (!reader_strval_terminate(This, &This->attr->localname))
+            return E_OUTOFMEMORY;
         reader_get_attribute_local_name(This, This->attr, name, len);
         break;
     default:
@@ -3364,6 +3479,8 @@ static const strval *reader_get_value(xmlreader *reader, BOOL ensure_allocated)
 
             return &ns->uri;
         }
+        if (ensure_allocated && !reader_strval_terminate(reader, &reader->attr->value))
+            return NULL;
         return &reader->attr->value;
     default:
         break;
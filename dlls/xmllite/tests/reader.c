@@ -2631,6 +2631,109 @@ static void test_attribute_by_name(void)
     IXmlReader_Release(reader);
 }
 
+static char *build_large_document(unsigned int count)
+{
+    static const char head[] = "<root a=\"x\ty\nz &amp; w\">\n";
+    static const char item[] = "<item n=\"v\tw\">text\twith ]] tab &lt; x</item>\n";
+    static const char tail[] = "</root>";
+    char *xml, *p;
+    unsigned int i;
+
+    p = xml = heap_alloc(sizeof(head) + count * (sizeof(item) - 1) + sizeof(tail));
+    strcpy(p, head);
+    p += strlen(head);
+    for (i = 0; i < count; i++)
+    {
+        memcpy(p, item, sizeof(item) - 1);
+        p += sizeof(item) - 1;
+    }
+    strcpy(p, tail);
+
+    return xml;
+}
+
+static void test_read_large_document(void)
+{
+    IXmlReader *reader;
+    unsigned int i;
+    XmlNodeType type;
+    LONG failures;
+    UINT line;
+    char *xml;
+    HRESULT hr;
+
+    hr = CreateXmlReader(&IID_IXmlReader, (void **)&reader, NULL);
+    ok(hr == S_OK, "Failed to create reader, hr %#x.\n", hr);
+
+    /* large enough to span many input chunks */
+    xml = build_large_document(2000);
+    set_input_string(reader, xml);
+
+    read_node(reader, XmlNodeType_Element);
+    next_attribute(reader);
+    reader_value(reader, L"x y z & w");
+    read_node(reader, XmlNodeType_Whitespace);
+
+    failures = winetest_get_failures();
+    for (i = 0; i < 2000; i++)
+    {
+        read_node(reader, XmlNodeType_Element);
+        reader_name(reader, L"item");
+        line = 0;
+        IXmlReader_GetLineNumber(reader, &line);
+        ok(line == i + 3, "item %u: got line %u\n", i, line);
+
+        next_attribute(reader);
+        reader_name(reader, L"n");
+        reader_value(reader, L"v w");
+
+        read_node(reader, XmlNodeType_Text);
+        reader_value(reader, L"text\twith ]] tab < x");
+        read_node(reader, XmlNodeType_EndElement);
+        read_node(reader, XmlNodeType_Whitespace);
+
+        if (winetest_get_failures() != failures) break;
+    }
+
+    read_node(reader, XmlNodeType_EndElement);
+    hr = IXmlReader_Read(reader, &type);
+    ok(hr == S_FALSE, "got %#x\n", hr);
+
+    heap_free(xml);
+
+    if (winetest_interactive)
+    {
+        unsigned int nodes = 0, count = 200000;
+        const WCHAR *value;
+        DWORD start, time;
+        size_t size;
+
+        xml = build_large_document(count);
+        size = strlen(xml);
+        set_input_string(reader, xml);
+
+        start = GetTickCount();
+        while (IXmlReader_Read(reader, &type) == S_OK)
+        {
+            if (type == XmlNodeType_Element)
+            {
+                while (IXmlReader_MoveToNextAttribute(reader) == S_OK)
+                    IXmlReader_GetValue(reader, &value, NULL);
+            }
+            else
+                IXmlReader_GetValue(reader, &value, NULL);
+            nodes++;
+        }
+        time = GetTickCount() - start;
+
+        trace("read %u nodes, %u KB in %u ms, %u KB/s\n", nodes, (UINT)(size / 1024), time,
+                time ? (UINT)(size / time * 1000 / 1024) : 0);
+        heap_free(xml);
+    }
+
+    IXmlReader_Release(reader);
+}
+
 START_TEST(reader)
 {
     test_reader_create();
@@ -2659,4 +2762,5 @@ START_TEST(reader)
     test_reader_position();
     test_string_pointers();
     test_attribute_by_name();
+    test_read_large_document();
 }
@@ -2958,6 +2958,7 @@ static FORCEINLINE LONG WINAPI InterlockedDecrement( LONG volatile *dest )
 #ifndef __i386__
 
 #pragma intrinsic(_InterlockedCompareExchangePointer)
+#pragma intrinsic(_InterlockedExchange64)
 #pragma intrinsic(_InterlockedExchangePointer)
 
 #define InterlockedCompareExchangePointer    _InterlockedCompareExchangePointer
@@ -2965,6 +2966,12 @@ static FORCEINLINE LONG WINAPI InterlockedDecrement( LONG volatile *dest )
 
 void *InterlockedCompareExchangePointer(void *volatile*,void*,void*);
 void *InterlockedExchangePointer(void *volatile*,void*);
+long long _InterlockedExchange64(long long volatile*,long long);
+
+static FORCEINLINE LONGLONG WINAPI InterlockedExchange64( LONGLONG volatile *dest, LONGLONG val )
+{
+    return _InterlockedExchange64( (long long volatile *)dest, val );
+}
 
 #else
 
@@ -2978,6 +2985,13 @@ static FORCEINLINE void *WINAPI InterlockedExchangePointer( void *volatile *dest
     return (void *)_InterlockedExchange( (long volatile*)dest, (long)val );
 }
 
+static FORCEINLINE LONGLONG WINAPI InterlockedExchange64( LONGLONG volatile *dest, LONGLONG val )
+{
+    LONGLONG ret;
+    do ret = *dest; while (_InterlockedCompareExchange64( (long long volatile *)dest, val, ret ) != ret);
+    return ret;
+}
+
 #endif
 
 #elif defined(__GNUC__)
@@ -3059,6 +3073,17 @@ static FORCEINLINE PVOID WINAPI InterlockedExchangePointer( PVOID volatile *dest
     return ret;
 }
 
+static FORCEINLINE LONGLONG WINAPI InterlockedExchange64( LONGLONG volatile *dest, LONGLONG val )
+{
+    LONGLONG ret;
+#ifdef __x86_64__
+    __asm__ __volatile__( "lock; xchgq %0,(%1)" : "=r" (ret) :"r" (dest), "0" (val) : "memory" );
+#else
+    do ret = *dest; while (!__sync_bool_compare_and_swap( dest, ret, val ));
+#endif
+    return ret;
+}
+
 #else
 
 static FORCEINLINE PVOID WINAPI InterlockedCompareExchangePointer( PVOID volatile *dest, PVOID xchg, PVOID compare )
@@ -3080,6 +3105,13 @@ static FORCEINLINE LONGLONG WINAPI InterlockedCompareExchange64( LONGLONG volati
 WINBASEAPI LONGLONG WINAPI InterlockedCompareExchange64(LONGLONG volatile*,LONGLONG,LONGLONG);
 #endif
 
+static FORCEINLINE LONGLONG WINAPI InterlockedExchange64( LONGLONG volatile *dest, LONGLONG val )
+{
+    LONGLONG ret;
+    do ret = *dest; while (InterlockedCompareExchange64( dest, val, ret ) != ret);
+    return ret;
+}
+
 #endif
 
 #endif  /* __GNUC__ */